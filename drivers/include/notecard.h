@@ -46,6 +46,13 @@ extern "C" {
 #endif
 
 #include <zephyr/device.h>
+#include <zephyr/kernel.h>
+
+#include <note.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 /**
  * @brief Typedef for a generic notecard callback
@@ -55,6 +62,29 @@ extern "C" {
  */
 typedef void (*notecard_cb_t)(const struct device *dev, void *user_data);
 
+/**
+ * @brief Typedef for a response callback of the asynchronous request API
+ *
+ * Callback is called from the worker thread of the notecard instance, while the worker holds the
+ * control of the notecard, so it should return quickly. Callback takes the ownership of the
+ * response and has to free it with NoteDeleteResponse().
+ *
+ * @param[in] dev	Device struct of the notecard driver instance that executed the request.
+ * @param[in] rsp	Response to the request, NULL if request failed or was dropped.
+ * @param[in] user_data	Arbitrary data that was passed to notecard_request_submit() call.
+ */
+typedef void (*notecard_rsp_cb_t)(const struct device *dev, J *rsp, void *user_data);
+
+/**
+ * @brief Response container used by notecard_request_submit_signal()
+ */
+struct notecard_async_rsp {
+	/* Raised with 0 when response arrives, with -EIO if request failed or was dropped. */
+	struct k_poll_signal signal;
+	/* Response to the request, owned by the caller after the signal was raised. */
+	J *rsp;
+};
+
 /**
  * @brief Take control with the notecard device
  *
@@ -64,10 +94,46 @@ typedef void (*notecard_cb_t)(const struct device *dev, void *user_data);
  * If another notecard device tries to take control, this function will block until the first
  * notecard releases control.
  *
+ * While the calling thread has control, everything that note-c allocates (requests built with
+ * NoteNewRequest() and responses) comes from the heap of this instance. Threads without control
+ * allocate from the default heap, see notecard_heap_select().
+ *
  * @param[in] dev	Device struct of notecard driver instance.
  */
 void notecard_ctrl_take(const struct device *dev);
 
+/**
+ * @brief Select the heap that threads without control allocate from.
+ *
+ * Requests can be built with NoteNewRequest() before taking control (e.g. to submit them with
+ * notecard_request_submit()), they are then allocated from the heap of the selected instance.
+ * By default, that is the first initialized instance. Memory can be freed by any thread, no
+ * matter which heap it came from.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ */
+void notecard_heap_select(const struct device *dev);
+
+/**
+ * @brief Take control with the notecard device, waiting for it at most the given time.
+ *
+ * Same as notecard_ctrl_take(), but gives up if the control is not released in time, e.g. because
+ * another thread holds it during a long hub.sync.
+ *
+ * Waiting threads get the control in the order of their priority (threads with equal priority in
+ * the order they started waiting), as soon as the current owner releases it. Owner inherits the
+ * priority of the most urgent waiter until it releases the control, so it can not be held back by
+ * threads of medium priority.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] timeout	Maximum time to wait for the control.
+ *
+ * @retval 0 on success, control needs to be released with notecard_ctrl_release().
+ * @retval -EBUSY if timeout is K_NO_WAIT and another thread has the control.
+ * @retval -EAGAIN if waiting for the control timed out.
+ */
+int notecard_ctrl_take_timeout(const struct device *dev, k_timeout_t timeout);
+
 /**
  * @brief Release control from notecard device
  *
@@ -75,25 +141,753 @@ void notecard_ctrl_take(const struct device *dev);
  */
 void notecard_ctrl_release(const struct device *dev);
 
+/**
+ * @brief Send a request to the notecard without waiting for the response.
+ *
+ * Request is sent as a notecard "cmd", to which notecard does not respond, so the receive phase,
+ * response allocation and response parsing are skipped entirely. Request created with
+ * NoteNewRequest() is converted into a command automatically. Use it for requests whose
+ * response is never read, like note.add or hub.set.
+ *
+ * Request is sent directly through the communication bus of the device, bypassing note-c, so
+ * the control of the notecard needs to be taken before calling this function.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] cmd	Request or command, it is freed by this function.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if the request could not be converted into a command or serialized.
+ * @retval -EIO if the communication bus failed.
+ */
+int notecard_cmd(const struct device *dev, J *cmd);
+
+/**
+ * @brief Request that is serialized at compile time, defined with NOTECARD_STATIC_REQUEST() or
+ * NOTECARD_STATIC_CMD().
+ */
+struct notecard_static_request {
+	/* Request JSON, terminated with a newline. */
+	const char *json;
+	size_t len;
+	/* Notecard does not respond to commands. */
+	bool is_cmd;
+};
+
+/**
+ * @brief Define a constant request, sent with notecard_request_static().
+ *
+ * Example:
+ *
+ * @code{.c}
+ * NOTECARD_STATIC_REQUEST(hub_sync, "{\"req\":\"hub.sync\"}");
+ * @endcode
+ *
+ * @param _name	Name of the request variable.
+ * @param _json	Request JSON, needs to be a string literal.
+ */
+#define NOTECARD_STATIC_REQUEST(_name, _json)                                                      \
+	static const struct notecard_static_request _name = {                                      \
+		.json = _json "\n",                                                                \
+		.len = sizeof(_json "\n") - 1,                                                     \
+		.is_cmd = false,                                                                   \
+	}
+
+/**
+ * @brief Define a constant command, sent with notecard_request_static().
+ *
+ * Same as NOTECARD_STATIC_REQUEST(), but the JSON names the request with "cmd" key, so
+ * notecard_request_static() does not wait for the response.
+ *
+ * @param _name	Name of the command variable.
+ * @param _json	Command JSON, needs to be a string literal.
+ */
+#define NOTECARD_STATIC_CMD(_name, _json)                                                          \
+	static const struct notecard_static_request _name = {                                      \
+		.json = _json "\n",                                                                \
+		.len = sizeof(_json "\n") - 1,                                                     \
+		.is_cmd = true,                                                                    \
+	}
+
+/**
+ * @brief Send a constant request and read its response.
+ *
+ * Request JSON is transmitted as it is, directly through the communication bus of the device,
+ * so nothing is allocated from the heap. It is meant for requests that are sent over and over
+ * with the same arguments, such as card.version, hub.sync or arming the attn pin with card.attn.
+ * Control of the notecard needs to be taken before calling this function.
+ *
+ * Response is read directly from the bus, waiting for it up to CONFIG_NOTECARD_RSP_TIMEOUT_MS.
+ * It can be parsed with JParse(), if needed.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] req	Request, defined with NOTECARD_STATIC_REQUEST() or NOTECARD_STATIC_CMD().
+ * @param[out] rsp	Buffer for the null-terminated response JSON, can be NULL if the response
+ *			is not needed. Unused for commands.
+ * @param[in] rsp_size	Size of the response buffer.
+ *
+ * @retval 0 on success.
+ * @retval -ETIMEDOUT if the response did not arrive in time.
+ * @retval -EMSGSIZE if the response did not fit into the buffer.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ */
+int notecard_request_static(const struct device *dev, const struct notecard_static_request *req,
+			    char *rsp, size_t rsp_size);
+
+/**
+ * @brief Statistics of a binary transfer.
+ */
+struct notecard_binary_stats {
+	/* Number of transferred (unencoded) bytes. */
+	size_t bytes;
+	/* Duration of the transfer. */
+	uint32_t duration_ms;
+	/* Achieved throughput. */
+	uint32_t bytes_per_sec;
+};
+
+/**
+ * @brief Write binary data to the notecard's binary storage area.
+ *
+ * Data is sent with card.binary.put requests of CONFIG_NOTECARD_BINARY_CHUNK_SIZE bytes. Every
+ * chunk is COBS encoded on the fly, while it is being transmitted directly from the given
+ * buffer, so no memory is allocated for the encoded data.
+ *
+ * Data is written at the given offset of the binary storage area, use card.binary request with
+ * "delete" set to true to clear the storage area before writing new data.
+ *
+ * Data is sent directly through the communication bus of the device, bypassing note-c, so the
+ * control of the notecard needs to be taken before calling this function.
+ *
+ * Requires CONFIG_NOTECARD_BINARY.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] offset	Offset in the binary storage area.
+ * @param[in] data	Data.
+ * @param[in] len	Length of the data.
+ * @param[out] stats	Statistics of the transfer, can be NULL.
+ *
+ * @retval 0 on success.
+ * @retval -EIO if notecard rejected the data.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ */
+int notecard_binary_put(const struct device *dev, size_t offset, const void *data, size_t len,
+			struct notecard_binary_stats *stats);
+
+/**
+ * @brief Read binary data from the notecard's binary storage area.
+ *
+ * Data is read with card.binary.get requests of CONFIG_NOTECARD_BINARY_CHUNK_SIZE bytes. Every
+ * chunk is COBS decoded on the fly, directly into the given buffer, and checked against its MD5
+ * checksum.
+ *
+ * Data is received directly through the communication bus of the device, bypassing note-c, so
+ * the control of the notecard needs to be taken before calling this function.
+ *
+ * Requires CONFIG_NOTECARD_BINARY.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] offset	Offset in the binary storage area.
+ * @param[out] buf	Buffer for the data.
+ * @param[in] len	Number of bytes to read.
+ * @param[out] stats	Statistics of the transfer, can be NULL.
+ *
+ * @retval 0 on success.
+ * @retval -EIO if notecard returned an error or the data did not match its checksum.
+ * @retval -EMSGSIZE if notecard returned more data than requested.
+ * @retval -EBADMSG if the data was not correctly encoded.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ */
+int notecard_binary_get(const struct device *dev, size_t offset, void *buf, size_t len,
+			struct notecard_binary_stats *stats);
+
+/**
+ * @brief Type of a field reported by the streaming response parser.
+ */
+enum notecard_json_type {
+	NOTECARD_JSON_STRING,
+	NOTECARD_JSON_NUMBER,
+	NOTECARD_JSON_BOOL,
+	NOTECARD_JSON_NULL,
+	NOTECARD_JSON_OBJECT_BEGIN,
+	NOTECARD_JSON_OBJECT_END,
+	NOTECARD_JSON_ARRAY_BEGIN,
+	NOTECARD_JSON_ARRAY_END,
+};
+
+/**
+ * @brief Field reported by the streaming response parser.
+ */
+struct notecard_json_field {
+	/* Key of the field, NULL for array elements and ends of objects and arrays. Keys longer
+	 * than CONFIG_NOTECARD_JSON_KEY_MAX_LEN are truncated. */
+	const char *key;
+	/* Nesting level of the field, fields of the response object are at level 1. */
+	uint8_t depth;
+	enum notecard_json_type type;
+	/* Null-terminated value of a string, number, bool or null field. Strings are unescaped,
+	 * other values are given as they appear in the JSON. */
+	const char *value;
+	size_t value_len;
+	/* Strings longer than CONFIG_NOTECARD_JSON_VALUE_MAX_LEN are reported in several pieces,
+	 * this flag is set on all but the last one. */
+	bool more;
+};
+
+/**
+ * @brief Callback, called for every field of a response as soon as it is received.
+ *
+ * Field is valid only during the callback.
+ *
+ * @return 0 to continue parsing, any other value to stop calling the callback. Value is then
+ * returned by the function that started parsing.
+ */
+typedef int (*notecard_json_cb_t)(const struct notecard_json_field *field, void *user_data);
+
+/**
+ * @brief Send a request and parse its response on the fly.
+ *
+ * Response is parsed in small pieces as they arrive from the bus and every field is reported
+ * through the callback, so neither the response string nor a cJSON tree of it is ever held in
+ * memory. Use it for responses with large bodies, like note.get or file.changes.
+ *
+ * Request is sent directly through the communication bus of the device, bypassing note-c, so
+ * the control of the notecard needs to be taken before calling this function.
+ *
+ * Requires CONFIG_NOTECARD_JSON_PARSER.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] req	Request, it is freed by this function.
+ * @param[in] cb	Callback, called for every field of the response.
+ * @param[in] user_data	User data, given to the callback.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if the request could not be serialized.
+ * @retval -EIO if the request could not be sent.
+ * @retval -ETIMEDOUT if the response did not arrive in time.
+ * @retval -EBADMSG if the response was malformed.
+ * @retval other Non-zero value that the callback returned.
+ */
+int notecard_request_parse(const struct device *dev, J *req, notecard_json_cb_t cb,
+			   void *user_data);
+
+/**
+ * @brief Writer that streams a request to the notecard, without building a cJSON tree.
+ *
+ * Fields are private, use notecard_writer_*() functions to access them.
+ */
+struct notecard_writer {
+	const struct device *dev;
+	/* Number of bytes written in the current segment. */
+	size_t segment_len;
+	/* Bit for every nesting level that already contains a field. */
+	uint32_t has_fields;
+	uint8_t depth;
+	bool is_cmd;
+	/* First error that occurred, further writes are skipped. */
+	int err;
+	/* Error was reported by the communication bus. */
+	bool bus_err;
+	/* Part of the request was already transmitted. */
+	bool flushed;
+	/* Bytes that were not yet transmitted. */
+	size_t buf_len;
+	char buf[CONFIG_NOTECARD_WRITER_BUF_SIZE];
+};
+
+/**
+ * @brief Start streaming a request to the notecard.
+ *
+ * Fields are added with notecard_writer_add_*() and notecard_writer_object_*() functions and are
+ * transmitted in CONFIG_NOTECARD_WRITER_BUF_SIZE pieces as they are added, so neither a cJSON
+ * tree nor the whole serialized request is ever held in memory. Request is finished with
+ * notecard_writer_end().
+ *
+ * Errors of the add functions are remembered and reported by notecard_writer_end(). If part of
+ * the failed request was already transmitted, notecard_writer_end() terminates it with a newline
+ * and drops the notecard's error response, so the next request is not appended to it. This is
+ * skipped after a bus error.
+ *
+ * Request is sent directly through the communication bus of the device, bypassing note-c, so
+ * the control of the notecard needs to be taken until notecard_writer_end() returns.
+ *
+ * @param[out] w	Writer.
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] req	Name of the request, for example "note.add".
+ */
+void notecard_writer_req_begin(struct notecard_writer *w, const struct device *dev,
+			       const char *req);
+
+/**
+ * @brief Start streaming a command to the notecard.
+ *
+ * Same as notecard_writer_req_begin(), but notecard does not respond to commands, so
+ * notecard_writer_end() returns as soon as the command is transmitted.
+ *
+ * @param[out] w	Writer.
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] cmd	Name of the command, for example "note.add".
+ */
+void notecard_writer_cmd_begin(struct notecard_writer *w, const struct device *dev,
+			       const char *cmd);
+
+/**
+ * @brief Add a string field to the request.
+ *
+ * @param[in] w		Writer.
+ * @param[in] key	Key of the field.
+ * @param[in] value	Null-terminated value, it is escaped as needed.
+ */
+void notecard_writer_add_string(struct notecard_writer *w, const char *key, const char *value);
+
+/**
+ * @brief Add an integer field to the request.
+ *
+ * @param[in] w		Writer.
+ * @param[in] key	Key of the field.
+ * @param[in] value	Value.
+ */
+void notecard_writer_add_int(struct notecard_writer *w, const char *key, JINTEGER value);
+
+/**
+ * @brief Add a number field to the request.
+ *
+ * @param[in] w		Writer.
+ * @param[in] key	Key of the field.
+ * @param[in] value	Value.
+ */
+void notecard_writer_add_number(struct notecard_writer *w, const char *key, JNUMBER value);
+
+/**
+ * @brief Add a boolean field to the request.
+ *
+ * @param[in] w		Writer.
+ * @param[in] key	Key of the field.
+ * @param[in] value	Value.
+ */
+void notecard_writer_add_bool(struct notecard_writer *w, const char *key, bool value);
+
+/**
+ * @brief Start a nested object field, for example "body" of a note.
+ *
+ * Fields added after this call belong to the nested object, until notecard_writer_object_end()
+ * is called.
+ *
+ * @param[in] w		Writer.
+ * @param[in] key	Key of the field.
+ */
+void notecard_writer_object_begin(struct notecard_writer *w, const char *key);
+
+/**
+ * @brief End the nested object that was started last.
+ *
+ * @param[in] w		Writer.
+ */
+void notecard_writer_object_end(struct notecard_writer *w);
+
+/**
+ * @brief Finish the request and read its response.
+ *
+ * Response is read directly from the bus, waiting for it up to CONFIG_NOTECARD_RSP_TIMEOUT_MS.
+ * It can be parsed with JParse(), if needed.
+ *
+ * @param[in] w		Writer.
+ * @param[out] rsp	Buffer for the null-terminated response JSON, can be NULL if the response
+ *			is not needed. Unused for commands.
+ * @param[in] rsp_size	Size of the response buffer.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if objects were not balanced.
+ * @retval -ETIMEDOUT if the response did not arrive in time.
+ * @retval -EMSGSIZE if the response did not fit into the buffer.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ */
+int notecard_writer_end(struct notecard_writer *w, char *rsp, size_t rsp_size);
+
+/**
+ * @brief Finish the request and parse its response on the fly.
+ *
+ * Same as notecard_writer_end(), but the response is reported field by field through the
+ * callback, see notecard_request_parse().
+ *
+ * Requires CONFIG_NOTECARD_JSON_PARSER.
+ *
+ * @param[in] w		Writer, started with notecard_writer_req_begin().
+ * @param[in] cb	Callback, called for every field of the response.
+ * @param[in] user_data	User data, given to the callback.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if objects were not balanced.
+ * @retval -ETIMEDOUT if the response did not arrive in time.
+ * @retval -EBADMSG if the response was malformed.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ * @retval other Non-zero value that the callback returned.
+ */
+int notecard_writer_end_parse(struct notecard_writer *w, notecard_json_cb_t cb, void *user_data);
+
+/**
+ * @brief Type of a note schema field, it is derived from the C type of the struct member.
+ */
+enum notecard_field_type {
+	NOTECARD_FIELD_BOOL,
+	NOTECARD_FIELD_INT8,
+	NOTECARD_FIELD_UINT8,
+	NOTECARD_FIELD_INT16,
+	NOTECARD_FIELD_UINT16,
+	NOTECARD_FIELD_INT32,
+	NOTECARD_FIELD_UINT32,
+	NOTECARD_FIELD_INT64,
+	NOTECARD_FIELD_FLOAT,
+	NOTECARD_FIELD_DOUBLE,
+	/* Null-terminated string in a char array. */
+	NOTECARD_FIELD_STRING,
+};
+
+/**
+ * @brief Field of a note schema, defined with NOTECARD_FIELD().
+ */
+struct notecard_field {
+	const char *name;
+	enum notecard_field_type type;
+	/* Offset and size of the member in the note struct. */
+	uint16_t offset;
+	uint16_t size;
+};
+
+/**
+ * @brief Note schema, defined with NOTECARD_SCHEMA_DEFINE().
+ */
+struct notecard_schema {
+	/* Notefile that the notes are added to, for example "sensors.qo". */
+	const char *file;
+	const struct notecard_field *fields;
+	size_t num_fields;
+};
+
+/**
+ * @brief Get type of a note schema field from the type of the expression.
+ *
+ * Fields of other types (e.g. int or char pointers) fail to compile, use fixed width integer
+ * types and char arrays instead.
+ */
+#define NOTECARD_FIELD_TYPE(member)                                                                \
+	_Generic((member),                                                                         \
+		bool: NOTECARD_FIELD_BOOL,                                                         \
+		int8_t: NOTECARD_FIELD_INT8,                                                       \
+		uint8_t: NOTECARD_FIELD_UINT8,                                                     \
+		int16_t: NOTECARD_FIELD_INT16,                                                     \
+		uint16_t: NOTECARD_FIELD_UINT16,                                                   \
+		int32_t: NOTECARD_FIELD_INT32,                                                     \
+		uint32_t: NOTECARD_FIELD_UINT32,                                                   \
+		int64_t: NOTECARD_FIELD_INT64,                                                     \
+		float: NOTECARD_FIELD_FLOAT,                                                       \
+		double: NOTECARD_FIELD_DOUBLE,                                                     \
+		char *: NOTECARD_FIELD_STRING)
+
+/**
+ * @brief Define a note schema field from a member of the note struct.
+ *
+ * Name of the member is the name of the field in the note body. Char pointers decay to the
+ * same type as char arrays, so they are rejected with a compile time check.
+ *
+ * @param _member	Name of the member.
+ * @param _type		Type of the note struct.
+ */
+#define NOTECARD_FIELD(_member, _type)                                                             \
+	{                                                                                          \
+		.name = STRINGIFY(_member),                                                        \
+		.type = NOTECARD_FIELD_TYPE(((_type *)0)->_member),                                \
+		.offset = offsetof(_type, _member),                                                \
+		.size = sizeof(((_type *)0)->_member) +                                            \
+			ZERO_OR_COMPILE_ERROR(!__builtin_types_compatible_p(                       \
+				__typeof__(((_type *)0)->_member), char *)),                       \
+	}
+
+/**
+ * @brief Define a note schema, notes of it are added with notecard_note_add().
+ *
+ * Example:
+ *
+ * @code{.c}
+ * struct sensor_note {
+ *	float temp;
+ *	uint16_t humidity;
+ *	bool door_open;
+ *	char status[16];
+ * };
+ *
+ * NOTECARD_SCHEMA_DEFINE(sensor_schema, struct sensor_note, "sensors.qo", temp, humidity,
+ *			  door_open, status);
+ * @endcode
+ *
+ * @param name		Name of the schema variable.
+ * @param type		Type of the note struct.
+ * @param notefile	Notefile that notes are added to.
+ * @param ...		Members of the note struct that are sent as fields of the note body.
+ */
+#define NOTECARD_SCHEMA_DEFINE(name, type, notefile, ...)                                          \
+	static const struct notecard_field name##_fields[] = {                                     \
+		FOR_EACH_FIXED_ARG(NOTECARD_FIELD, (,), type, __VA_ARGS__)};                       \
+	const struct notecard_schema name = {                                                      \
+		.file = notefile,                                                                  \
+		.fields = name##_fields,                                                           \
+		.num_fields = ARRAY_SIZE(name##_fields),                                           \
+	}
+
+/**
+ * @brief Add a note of the schema to its notefile.
+ *
+ * The first time a note of the schema is added to the notecard, the matching note.template is
+ * registered, so the notecard stores and uploads the notes in compact binary form instead of as
+ * JSON. Note is serialized straight from the struct to the bus, with notecard_writer_*(), so no
+ * cJSON tree is built and nothing is allocated from the heap.
+ *
+ * Requires CONFIG_NOTECARD_SCHEMA. Control of the notecard needs to be taken.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] schema	Schema, defined with NOTECARD_SCHEMA_DEFINE().
+ * @param[in] note	Note struct of the schema.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if a string field is not null-terminated.
+ * @retval -EBADMSG if the notecard responded with an error.
+ * @retval -ETIMEDOUT if the response did not arrive in time.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ */
+int notecard_note_add(const struct device *dev, const struct notecard_schema *schema,
+		      const void *note);
+
+/**
+ * @brief Send a query to the notecard, or return its cached response.
+ *
+ * Responses are cached per instance, under the whole JSON text of the request, so the same
+ * request with different arguments is cached separately. How long a response is kept depends on
+ * the name of the request, see CONFIG_NOTECARD_CACHE_TTL_* options. Requests with a zero time to
+ * live, error responses and responses longer than CONFIG_NOTECARD_CACHE_RSP_MAX_LEN are never
+ * cached.
+ *
+ * Cached response is returned without taking the control of the notecard, otherwise the control
+ * is taken while the request is sent. Request is sent directly through the communication bus of
+ * the device, bypassing note-c.
+ *
+ * If another thread is already sending the same request, this call waits for and shares its
+ * response instead of sending the request again, see CONFIG_NOTECARD_CACHE_COALESCE_SLOTS. This
+ * also applies to requests that are not cached, so only read-only queries (e.g. card.location or
+ * file.changes) should be sent with this function. Responses longer than
+ * CONFIG_NOTECARD_CACHE_RSP_MAX_LEN are not shared, waiting threads then send the request
+ * themselves. Caller must not hold the control of the notecard, since the other thread might be
+ * waiting for it.
+ *
+ * Requires CONFIG_NOTECARD_CACHE.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] req	Null-terminated unformatted request JSON (no whitespace between keys and
+ *			values), for example "{\"req\":\"card.version\"}".
+ * @param[out] rsp	Buffer for the null-terminated response JSON.
+ * @param[in] rsp_size	Size of the response buffer.
+ *
+ * @retval 0 on success.
+ * @retval -ETIMEDOUT if the response did not arrive in time.
+ * @retval -EMSGSIZE if the response did not fit into the buffer.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ */
+int notecard_request_cached(const struct device *dev, const char *req, char *rsp,
+			    size_t rsp_size);
+
+/**
+ * @brief Drop cached responses, e.g. after a request that changes them.
+ *
+ * Requires CONFIG_NOTECARD_CACHE.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] name	Name of the request whose responses are dropped, for example "hub.get".
+ *			NULL drops all responses.
+ */
+void notecard_cache_invalidate(const struct device *dev, const char *name);
+
+/**
+ * @brief Response cache counters.
+ */
+struct notecard_cache_stats {
+	/* Number of requests answered from the cache. */
+	uint32_t hits;
+	/* Number of cacheable requests that were sent to the notecard. */
+	uint32_t misses;
+	/* Number of requests that shared the response of the same request of another thread. */
+	uint32_t coalesced;
+};
+
+/**
+ * @brief Get response cache counters of a Notecard instance.
+ *
+ * Requires CONFIG_NOTECARD_CACHE.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[out] stats	Counters.
+ */
+void notecard_cache_stats_get(const struct device *dev, struct notecard_cache_stats *stats);
+
+/**
+ * @brief Append a note to the offline note queue.
+ *
+ * Note is written to flash right away, it is sent to the notecard later by a background worker,
+ * together with other queued notes under a single control take. Worker only sends notes when the
+ * notecard is present and is not in use by another thread, so this call never waits for the
+ * notecard.
+ *
+ * Notes are sent at least once: notes that were sent right before a reboot, but whose batch was
+ * not yet marked as sent in flash, are sent again after it. When the queue is full, oldest notes
+ * are dropped.
+ *
+ * Requires CONFIG_NOTECARD_QUEUE and queue-partition in the devicetree.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[in] req	Null-terminated request JSON, for example
+ *			"{\"req\":\"note.add\",\"file\":\"data.qo\",\"body\":{\"temp\":21.5}}".
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if the instance has no queue partition.
+ * @retval -EMSGSIZE if the request is longer than CONFIG_NOTECARD_QUEUE_NOTE_MAX_LEN.
+ * @retval -errno Other negative errno code if writing to flash failed.
+ */
+int notecard_queue_add(const struct device *dev, const char *req);
+
+/**
+ * @brief Send queued notes now, instead of after CONFIG_NOTECARD_QUEUE_DRAIN_DELAY_MS or
+ * CONFIG_NOTECARD_QUEUE_RETRY_MS.
+ *
+ * Requires CONFIG_NOTECARD_QUEUE.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ */
+void notecard_queue_drain(const struct device *dev);
+
+/**
+ * @brief Offline note queue metrics.
+ */
+struct notecard_queue_stats {
+	/* Number of notes waiting in the queue. */
+	uint32_t depth;
+	/* Number of notes added since boot. */
+	uint32_t added;
+	/* Number of notes sent to the notecard since boot. */
+	uint32_t drained;
+	/* Number of notes that the notecard responded to with an error, they are not retried. */
+	uint32_t rejected;
+	/* Number of notes dropped because the queue was full. */
+	uint32_t dropped;
+	/* Notes per second sent by the last batch. */
+	uint32_t drain_rate;
+};
+
+/**
+ * @brief Get offline note queue metrics of a Notecard instance.
+ *
+ * Requires CONFIG_NOTECARD_QUEUE.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[out] stats	Metrics.
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if the instance has no queue partition.
+ */
+int notecard_queue_stats_get(const struct device *dev, struct notecard_queue_stats *stats);
+
 /**
  * @brief Obtain the amount of free memory available on the Notecard.
  *
  * The "free memory" refers to the internal heap memory that can be set with
- * CONFIG_NOTECARD_HEAP_SIZE Kconfig option.
+ * CONFIG_NOTECARD_HEAP_SIZE Kconfig option or heap-size devicetree property. When there are
+ * several Notecard instances, free memory of all their heaps is summed up.
  *
- * @note This function way copied from note-c library and refactored. That way we avoid spamming the
- * logs with "no memory" messages that the NoteMemAvailable would trigger otherwise.
+ * Value is read from the counters that the heap keeps up to date, the heap itself is not touched.
+ * Without CONFIG_SYS_HEAP_RUNTIME_STATS the heap's own bookkeeping is not counted, so the value is
+ * slightly too large.
  *
  * @return Available memory in bytes.
  */
 size_t notecard_available_memory(void);
 
+/**
+ * @brief Statistics of the heap used by note-c while a Notecard instance has control.
+ */
+struct notecard_mem_stats {
+	/* Free bytes in the heap. */
+	size_t free_bytes;
+	/* Allocated bytes in the heap. */
+	size_t allocated_bytes;
+	/* Maximum number of bytes that were allocated at the same time. */
+	size_t max_allocated_bytes;
+	/* Lower bound of the largest free block. If it is much smaller than free_bytes, the heap
+	 * might be fragmented. */
+	size_t largest_free_min;
+	/* Number of live heap allocations. */
+	uint32_t num_allocs;
+	/* Number of heap allocations that failed. */
+	uint32_t alloc_failures;
+};
+
+/**
+ * @brief Get statistics of the heap used by note-c while given Notecard instance has control.
+ *
+ * Runs in constant time and does not allocate from the heap, so it is safe to call while requests
+ * are in progress. Allocations served by slab pools (see CONFIG_NOTECARD_ALLOC_SLAB) are not
+ * included.
+ *
+ * Requires CONFIG_NOTECARD_MEM_STATS.
+ *
+ * @param[in] dev	Notecard device.
+ * @param[out] stats	Statistics.
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if CONFIG_NOTECARD_MEM_STATS is disabled.
+ * @retval -errno Negative errno code on failure.
+ */
+int notecard_mem_stats_get(const struct device *dev, struct notecard_mem_stats *stats);
+
+/**
+ * @brief Statistics of a single slab pool.
+ */
+struct notecard_slab_stats {
+	/* Size of a single block in bytes. */
+	uint32_t block_size;
+	/* Number of blocks in the pool. */
+	uint32_t num_blocks;
+	/* Number of blocks currently in use. */
+	uint32_t num_used;
+	/* Maximum number of blocks that were in use at the same time. */
+	uint32_t max_used;
+	/* Number of allocations served from this pool. */
+	uint32_t hits;
+	/* Number of allocations that fit this pool, but fell back to the heap, since the pool was
+	 * exhausted. */
+	uint32_t misses;
+};
+
+/**
+ * @brief Get statistics of a slab pool used by the allocator.
+ *
+ * Pools are indexed from the smallest block size upwards, iterate from 0 until -EINVAL is
+ * returned to get all of them.
+ *
+ * Requires CONFIG_NOTECARD_ALLOC_SLAB.
+ *
+ * @param[in] pool_idx	Index of the pool.
+ * @param[out] stats	Statistics.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if there is no pool with given index.
+ * @retval -ENOTSUP if slab pools are not enabled.
+ */
+int notecard_slab_stats_get(size_t pool_idx, struct notecard_slab_stats *stats);
+
 /**
  * @brief Enable interrupt on attn pin and register an attn pin callback.
  *
  * Each notecard device can register only a single attn pin callback.
  *
- * Attn pin callback is called when attn pin fires (goes to active state).
+ * Attn pin callback is called when attn pin fires (goes to active state). Callback is called from
+ * the interrupt context, unless CONFIG_NOTECARD_ATTN_DEFERRED is enabled, in which case it is
+ * called from a workqueue and can take control of the notecard.
  *
  * @param[in] dev		Device struct of notecard driver instance.
  * @param[in] attn_cb		Attn pin callback.
@@ -101,6 +895,57 @@ size_t notecard_available_memory(void);
  */
 void notecard_attn_cb_register(const struct device *dev, notecard_cb_t attn_cb, void *user_data);
 
+/**
+ * @brief Attn pin events that were coalesced into a single callback call.
+ */
+struct notecard_attn_event {
+	/* Number of times attn pin fired since the previous callback call. */
+	uint32_t count;
+	/* Uptime in milliseconds when attn pin fired last. */
+	int64_t timestamp;
+};
+
+/**
+ * @brief Set the workqueue that attn pin callback is called from.
+ *
+ * By default the callback is called from the dedicated workqueue (CONFIG_NOTECARD_ATTN_WORKQ) or
+ * from the system workqueue.
+ *
+ * Requires CONFIG_NOTECARD_ATTN_DEFERRED.
+ *
+ * @param[in] dev		Device struct of notecard driver instance.
+ * @param[in] workq		Workqueue, NULL to use the default one.
+ */
+void notecard_attn_workq_set(const struct device *dev, struct k_work_q *workq);
+
+/**
+ * @brief Get attn pin events that were dispatched with the last callback call.
+ *
+ * Meant to be called from the attn pin callback.
+ *
+ * Requires CONFIG_NOTECARD_ATTN_DEFERRED.
+ *
+ * @param[in] dev		Device struct of notecard driver instance.
+ * @param[out] event		Events.
+ */
+void notecard_attn_event_get(const struct device *dev, struct notecard_attn_event *event);
+
+/**
+ * @brief Get the signal that is raised whenever attn pin fires.
+ *
+ * Signal is raised directly from the interrupt, with the number of attn events that were not
+ * yet dispatched to the callback as its result, so threads can wait for attn pin with k_poll(),
+ * even without registering a callback. Signal needs to be reset with k_poll_signal_reset()
+ * before waiting on it again.
+ *
+ * Requires CONFIG_NOTECARD_ATTN_DEFERRED and attn-p-gpios in the devicetree.
+ *
+ * @param[in] dev		Device struct of notecard driver instance.
+ *
+ * @return Signal.
+ */
+struct k_poll_signal *notecard_attn_signal_get(const struct device *dev);
+
 /**
  * @brief Register an post take callback.
  *
@@ -134,11 +979,15 @@ void notecard_pre_release_cb_register(const struct device *dev, notecard_cb_t pr
 /**
  * @brief Check if notecard is present.
  *
- * Notecard is considered present, if it responds back to the request.
+ * Notecard is considered present, if it responds back to the request. Function returns as soon
+ * as the response arrives, but waits for it at most CONFIG_NOTECARD_PROBE_TIMEOUT_MS.
  *
+ * Result is also stored as the ready state of the instance, see notecard_is_ready().
  *
  * @note This function bypasses the entire note-c library and directly uses the correct
- * communication bus via Zephyr API.
+ * communication bus via Zephyr API, so the control of the notecard needs to be taken before
+ * calling it. On UART it discards received bytes that were not read yet, so calling it without
+ * control would also discard the response of another thread's request.
  *
  * @param[in] dev		Device struct of notecard driver instance.
  *
@@ -146,6 +995,280 @@ void notecard_pre_release_cb_register(const struct device *dev, notecard_cb_t pr
  */
 bool notecard_is_present(const struct device *dev);
 
+/**
+ * @brief Wait until notecard is ready, for example after power-on.
+ *
+ * Notecard is checked with notecard_is_present() until it responds or the timeout expires, so
+ * the function returns as soon as notecard finishes booting.
+ *
+ * @note Control of the notecard needs to be taken before calling this function.
+ *
+ * @param[in] dev		Device struct of notecard driver instance.
+ * @param[in] timeout		How long to wait.
+ *
+ * @retval 0 if notecard is ready.
+ * @retval -ETIMEDOUT if notecard did not respond in time.
+ */
+int notecard_wait_ready(const struct device *dev, k_timeout_t timeout);
+
+/**
+ * @brief Get ready state of the notecard.
+ *
+ * Returns the result of the last notecard_is_present() or notecard_wait_ready() call, without
+ * touching the communication bus, so it can be called without taking control.
+ *
+ * @param[in] dev		Device struct of notecard driver instance.
+ *
+ * @return True if notecard responded to the last check, false otherwise.
+ */
+bool notecard_is_ready(const struct device *dev);
+
+/**
+ * @brief Submit a request to the notecard without blocking.
+ *
+ * Request is queued and later executed by the worker thread of the notecard instance with
+ * NoteRequestResponse(). Worker executes all queued requests back-to-back under a single
+ * notecard_ctrl_take(), so the caller does not need to hold control while building or submitting
+ * the request. Request built without control is allocated from the default heap, see
+ * notecard_heap_select().
+ *
+ * If the queue is full, behaviour depends on CONFIG_NOTECARD_ASYNC_QUEUE_FULL_POLICY: either
+ * the new request is rejected, or the oldest queued request is dropped (its callback is called
+ * from the worker thread with NULL response).
+ *
+ * Requires CONFIG_NOTECARD_ASYNC.
+ *
+ * @param[in] dev		Device struct of notecard driver instance.
+ * @param[in] req		Request, driver takes the ownership of it on success.
+ * @param[in] rsp_cb		Response callback, can be NULL if response is not needed.
+ * @param[in] user_data		Arbitrary data that is passed to the callback.
+ *
+ * @retval 0 on success.
+ * @retval -ENOBUFS if the queue is full (with the drop oldest policy, if as many dropped requests
+ * are still waiting for their callbacks as the queue is deep), caller keeps the ownership of the
+ * request.
+ */
+int notecard_request_submit(const struct device *dev, J *req, notecard_rsp_cb_t rsp_cb,
+			    void *user_data);
+
+/**
+ * @brief Submit a request to the notecard without blocking and get notified with k_poll signal.
+ *
+ * Same as notecard_request_submit(), but instead of calling a callback, the response is stored
+ * into the given container and its signal is raised. Container needs to stay valid until the
+ * signal is raised.
+ *
+ * Requires CONFIG_NOTECARD_ASYNC.
+ *
+ * @param[in] dev		Device struct of notecard driver instance.
+ * @param[in] req		Request, driver takes the ownership of it on success.
+ * @param[in] async_rsp		Response container, signal is (re)initialized by this function.
+ *
+ * @retval 0 on success.
+ * @retval -ENOBUFS if the queue is full, caller keeps the ownership of the request.
+ */
+int notecard_request_submit_signal(const struct device *dev, J *req,
+				   struct notecard_async_rsp *async_rsp);
+
+/**
+ * @brief Receive statistics of the interrupt driven uart bus.
+ */
+struct notecard_uart_rx_stats {
+	/* Number of bytes received from the Notecard. */
+	uint32_t received;
+	/* Number of received bytes dropped, because the receive ring buffer was full. */
+	uint32_t ring_overruns;
+	/* Number of overrun errors reported by the uart driver. */
+	uint32_t hw_overruns;
+};
+
+/**
+ * @brief Get receive statistics of the notecard on the uart bus.
+ *
+ * Statistics are collected only when CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN is enabled. Non-zero
+ * overrun counters mean that the CONFIG_NOTECARD_UART_RX_BUF_SIZE is too small for the responses
+ * that are read, or that the uart interrupt is starved by higher priority interrupts.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[out] stats	Statistics.
+ *
+ * @retval 0 on success.
+ * @retval -ENOTSUP if notecard is not on the uart bus or statistics are not collected.
+ */
+int notecard_uart_rx_stats_get(const struct device *dev, struct notecard_uart_rx_stats *stats);
+
+/* Number of buckets of a latency histogram. */
+#define NOTECARD_STATS_BUCKETS 20
+
+/**
+ * @brief Latency histogram with fixed, power of two sized buckets.
+ *
+ * Bucket 0 counts durations shorter than 32 us, bucket i counts durations from 2^(i + 4) us up to
+ * 2^(i + 5) us. Last bucket also counts all longer durations.
+ */
+struct notecard_latency_hist {
+	uint32_t buckets[NOTECARD_STATS_BUCKETS];
+	/* Number of recorded durations. */
+	uint32_t count;
+	/* Longest recorded duration in microseconds. */
+	uint32_t max_us;
+	/* Sum of all recorded durations in microseconds. */
+	uint64_t total_us;
+};
+
+/**
+ * @brief Latency and bus statistics of a Notecard instance.
+ */
+struct notecard_stats {
+	/* Time spent waiting for the control in notecard_ctrl_take(). */
+	struct notecard_latency_hist lock_wait;
+	/* Time from taking the control until releasing it, recursive takes are not counted
+	 * separately. */
+	struct notecard_latency_hist lock_hold;
+	/* Time spent transmitting a single piece of a request to the bus. */
+	struct notecard_latency_hist tx;
+	/* Time from the end of the transmission until the whole response was received. */
+	struct notecard_latency_hist rx_wait;
+	/* Time spent parsing responses by the driver's streaming parser. */
+	struct notecard_latency_hist parse;
+	/* Number of bytes transmitted to and received from the Notecard. */
+	uint32_t tx_bytes;
+	uint32_t rx_bytes;
+	/* Number of failed bus transmissions and receptions. */
+	uint32_t tx_errors;
+	uint32_t rx_errors;
+	/* Number of notecard_ctrl_take_timeout() calls that did not get the control in time. */
+	uint32_t ctrl_timeouts;
+};
+
+/**
+ * @brief Get latency and bus statistics of a Notecard instance.
+ *
+ * Transmissions and receptions of note-c and of the driver's own API (e.g. notecard_cmd(),
+ * notecard_writer_*()) are both included. Responses that note-c parses itself are not included
+ * in the parse histogram.
+ *
+ * Requires CONFIG_NOTECARD_STATS.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ * @param[out] stats	Statistics.
+ */
+void notecard_stats_get(const struct device *dev, struct notecard_stats *stats);
+
+/**
+ * @brief Clear latency and bus statistics of a Notecard instance.
+ *
+ * Requires CONFIG_NOTECARD_STATS.
+ *
+ * @param[in] dev	Device struct of notecard driver instance.
+ */
+void notecard_stats_reset(const struct device *dev);
+
+/**
+ * @brief Get the duration below which the given percentage of durations in a histogram are.
+ *
+ * Result is the upper bound of the bucket that contains the percentile, capped with the longest
+ * recorded duration, so it is exact only up to the bucket resolution.
+ *
+ * Requires CONFIG_NOTECARD_STATS.
+ *
+ * @param[in] hist	Latency histogram, e.g. one from notecard_stats_get().
+ * @param[in] percent	Percentile, 0 - 100.
+ *
+ * @return Duration in microseconds, 0 if the histogram is empty.
+ */
+uint32_t notecard_latency_hist_percentile(const struct notecard_latency_hist *hist,
+					  unsigned int percent);
+
+/* Maximum number of bytes in a single record of a captured session. */
+#define NOTECARD_CAPTURE_RECORD_MAX_LEN 256
+
+/**
+ * @brief Direction of the bytes in a captured record.
+ */
+enum notecard_capture_dir {
+	NOTECARD_CAPTURE_TX,
+	NOTECARD_CAPTURE_RX,
+};
+
+/**
+ * @brief Header of a record in a captured bus session.
+ *
+ * Session is a sequence of records, each is a header followed by len bytes that were transmitted
+ * to or received from the Notecard.
+ */
+struct notecard_capture_hdr {
+	/* Uptime in microseconds (wraps around) when the bytes were transmitted, or when the first
+	 * of them was read by note-c. Received bytes are timestamped when note-c polls for them,
+	 * not when they arrived on the bus, so rx timestamps are late by up to a poll interval. */
+	uint32_t timestamp_us;
+	/* Number of bytes that follow the header. */
+	uint16_t len;
+	/* Direction, see enum notecard_capture_dir. */
+	uint8_t dir;
+	uint8_t reserved;
+};
+
+/**
+ * @brief Move captured records out of the capture buffer.
+ *
+ * Only whole records are moved, a buffer of NOTECARD_CAPTURE_RECORD_MAX_LEN +
+ * sizeof(struct notecard_capture_hdr) bytes always fits at least one. Output can be given to
+ * notecard_replay_load() as is.
+ *
+ * Requires CONFIG_NOTECARD_CAPTURE.
+ *
+ * @param[out] buf	Buffer for the records.
+ * @param[in] size	Size of the buffer.
+ *
+ * @return Number of bytes written to the buffer, 0 if nothing was captured.
+ */
+size_t notecard_capture_get(uint8_t *buf, size_t size);
+
+/**
+ * @brief Drop all captured records.
+ *
+ * Requires CONFIG_NOTECARD_CAPTURE.
+ */
+void notecard_capture_clear(void);
+
+/**
+ * @brief Get number of records that were dropped, since the capture buffer was full.
+ *
+ * Oldest records are dropped first. Counter is cleared by notecard_capture_clear().
+ *
+ * Requires CONFIG_NOTECARD_CAPTURE.
+ */
+uint32_t notecard_capture_dropped(void);
+
+/**
+ * @brief Load a captured session, which is replayed instead of talking to the Notecard.
+ *
+ * Every time the driver transmits a request (i.e. a line), replay moves past the next captured
+ * request and returns records received after it as the response, with the same delays as they
+ * were captured. Content of the requests is not compared, since note-c adds fields that change
+ * between requests, only empty lines (which note-c sends to reset the Notecard) are matched
+ * with empty lines.
+ *
+ * Session needs to stay valid while it is replayed. Loading it again restarts the replay.
+ *
+ * Requires CONFIG_NOTECARD_REPLAY.
+ *
+ * @param[in] session	Session, in the format returned by notecard_capture_get().
+ * @param[in] len	Length of the session in bytes.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if session is malformed.
+ */
+int notecard_replay_load(const uint8_t *session, size_t len);
+
+/**
+ * @brief Check if the whole loaded session was replayed.
+ *
+ * Requires CONFIG_NOTECARD_REPLAY.
+ */
+bool notecard_replay_done(void);
+
 #ifdef __cplusplus
 }
 #endif
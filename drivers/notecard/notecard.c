@@ -10,10 +10,8 @@
 
 #include <zephyr/devicetree.h>
 #include <zephyr/drivers/gpio.h>
-#include <zephyr/drivers/uart.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
-#include <zephyr/logging/log_ctrl.h>
 #include <zephyr/sys/__assert.h>
 
 #include <note.h>
@@ -22,79 +20,44 @@
 
 LOG_MODULE_REGISTER(notecard, CONFIG_NOTECARD_LOG_LEVEL);
 
-static uint8_t prv_heap_buf[CONFIG_NOTECARD_HEAP_SIZE];
-static struct k_heap prv_heap;
-static struct k_mutex prv_mutex;
+/* note-c keeps its hooks and state in globals, so only a single instance can use it at a time,
+ * regardless of how many instances there are. */
+static K_MUTEX_DEFINE(prv_mutex);
 
-/**
- * @brief Helper function to check if string starts with a pattern.
- *
- * @param[in] str	Null-terminated string.
- * @param[in] pattern   Null-terminated string.
- *
- * @return True if string starts with pattern, false otherwise.
- */
-static inline bool prv_str_starts_with(const char *str, const char *pattern)
-{
-	return strncmp(str, pattern, strlen(pattern)) == 0;
-}
+/* Notecard instance that currently has the control and how many times it took it, since the
+ * prv_mutex can be locked recursively. */
+static const struct device *prv_owner;
+static k_tid_t prv_owner_thread;
+static uint32_t prv_owner_depth;
 
-/**
- * @brief Helper function to determine log level of the message.
- *
- * @param[in] message
- *
- * @return log level of the message.
- */
-static inline uint8_t prv_determine_log_level(const char *message)
-{
-	if (prv_str_starts_with(message, "[ERROR]")) {
-		return LOG_LEVEL_ERR;
-	}
-	if (prv_str_starts_with(message, "[WARN]")) {
-		return LOG_LEVEL_WRN;
-	}
-	if (prv_str_starts_with(message, "[INFO]")) {
-		return LOG_LEVEL_INF;
-	}
-	if (prv_str_starts_with(message, "[DEBUG]")) {
-		return LOG_LEVEL_DBG;
-	}
-	return LOG_LEVEL_NONE;
-}
+/* When the owner took the control, for the lock hold statistics. */
+static uint32_t prv_owner_since;
 
-/**
- * @brief Helper function to log message with appropriate log level.
- *
- * @param[in] log_level
- * @param[in] message
- */
-static inline void prv_log_with_level(uint8_t log_level, const char *message)
-{
-	switch (log_level) {
-	case LOG_LEVEL_ERR:
-		LOG_ERR("%s", message);
-		break;
-	case LOG_LEVEL_WRN:
-		LOG_WRN("%s", message);
-		break;
-	case LOG_LEVEL_INF:
-		LOG_INF("%s", message);
-		break;
-	case LOG_LEVEL_DBG:
-	default:
-		LOG_DBG("%s", message);
-		break;
-	}
-}
+/* Notecard instance whose bus is currently attached to note-c. */
+static const struct device *prv_attached;
 
 /**
  * @brief Zephyr-specific `delay` function required by the note-c lib.
  *
- * Puts the current thread to sleep.
+ * Puts the current thread to sleep. note-c mostly sleeps while it waits for the response, so if
+ * the attached bus can tell when something is received, sleep ends as soon as it is. Bus only
+ * ends the sleep early while a response is awaited, other delays are slept in full.
  */
 static void zephyr_delay(uint32_t ms)
 {
+#if CONFIG_NOTECARD_RX_WAKE
+	const struct device *dev = prv_attached;
+
+	if (dev) {
+		const struct notecard_config *config = dev->config;
+
+		if (config->bus.rx_wait) {
+			config->bus.rx_wait(&config->bus, K_MSEC(ms));
+			return;
+		}
+	}
+#endif
+
 	k_sleep(K_MSEC(ms));
 }
 
@@ -108,87 +71,6 @@ static uint32_t zephyr_millis(void)
 	return (uint32_t)k_uptime_get();
 }
 
-/**
- * @brief Zephyr-specific `log print` function required by the note-c lib.
- *
- * Below logic cleans up the message by removing trailing whitespace characters before printing.
- *
- * Additionally, log_level logic determines the log level of the message (since every message is
- * precedded with either, [ERROR], [WARN], [INFO], or [DEBUG]) and then uses appropriate log macro.
- * Sadly macros could not be used, since log_level in Z_LOG (macro used by all public LOG_* macros)
- * needs to be known at compile time, which is not the case here.
- */
-static size_t zephyr_log_print(const char *message)
-{
-	static uint8_t log_level = LOG_LEVEL_NONE;
-
-	if (log_level == LOG_LEVEL_NONE) {
-		log_level = prv_determine_log_level(message);
-		return 0;
-	}
-
-	char cleaned_msg[256];
-	// size_t bytes_left = strlen(message);
-	// size_t chunk_size = 255;
-	// int i = 0;
-	// while (bytes_left) {
-	// 	/* Handle the case where the size of the image sent is not divisible with
-	// 	 * chunk_size.
-	// 	 */
-	// 	size_t bytes_to_send = bytes_left >= chunk_size ? chunk_size : bytes_left;
-	// 	strncpy(cleaned_msg, &message[i * chunk_size], bytes_to_send);
-	// 	cleaned_msg[bytes_to_send] = '\0';
-	// 	LOG_RAW("%s", cleaned_msg);
-	// 	bytes_left -= bytes_to_send;
-	// 	i++;
-	// }
-
-	if (strlen(message) > 256) {
-		strncpy(cleaned_msg, message, 256);
-		cleaned_msg[255] = '\0';
-		prv_log_with_level(log_level, cleaned_msg);
-		log_level = LOG_LEVEL_NONE;
-		return 0;
-	}
-
-	char const *end = message;
-
-	while (!(*end == '\0' || *end == '\r')) {
-		end++;
-	}
-
-	strncpy(cleaned_msg, message, end - message);
-	cleaned_msg[end - message] = '\0';
-
-	if (strlen(cleaned_msg) > 0) {
-		prv_log_with_level(log_level, cleaned_msg);
-		log_level = LOG_LEVEL_NONE;
-	}
-
-	return 0;
-}
-
-/**
- * @brief Zephyr-specific `malloc` function required by the note-c lib.
- */
-static void *zephyr_malloc(size_t size)
-{
-	void *ptr = k_heap_alloc(&prv_heap, size, K_NO_WAIT);
-	if (!ptr) {
-		LOG_ERR("Memory allocation failed!");
-	}
-
-	return ptr;
-}
-
-/**
- * @brief Zephyr-specific `free` function required by the note-c lib.
- */
-static void zephyr_free(void *mem)
-{
-	k_heap_free(&prv_heap, mem);
-}
-
 static void attn_pin_cb_handler(const struct device *port, struct gpio_callback *cb,
 				gpio_port_pins_t pins)
 {
@@ -204,11 +86,18 @@ static void attn_pin_cb_handler(const struct device *port, struct gpio_callback
 
 	int attn_pin_state = gpio_pin_get_dt(&config->attn_p_gpio);
 
+#if CONFIG_NOTECARD_ATTN_DEFERRED
+	/* Callback is called later from the workqueue. */
+	if (attn_pin_state) {
+		notecard_attn_dispatch(dev);
+	}
+#else
 	/* Call callback only, if the state changed, attn pin state is high and callback was
 	 * given.*/
 	if (attn_pin_state && data->attn_cb_data.cb) {
 		data->attn_cb_data.cb(dev, data->attn_cb_data.user_data);
 	}
+#endif
 
 	/* "Re-enable back" interrupt, but for a different level */
 	gpio_pin_interrupt_configure_dt(&config->attn_p_gpio, attn_pin_state
@@ -257,37 +146,93 @@ static int prv_configure_interrupt_gpio(struct gpio_callback *gpio_cb,
 
 static int notecard_init(const struct device *dev)
 {
-	k_heap_init(&prv_heap, prv_heap_buf, CONFIG_NOTECARD_HEAP_SIZE);
-	k_mutex_init(&prv_mutex);
+	struct notecard_data *data = dev->data;
+	const struct notecard_config *config = dev->config;
 
-	NoteSetFnDebugOutput(zephyr_log_print);
+	notecard_alloc_init(&data->heap, config->heap_buf, config->heap_size);
 
-	/* Set platform specific hooks. */
-	NoteSetFn(zephyr_malloc, zephyr_free, zephyr_delay, zephyr_millis);
+#if CONFIG_NOTECARD_LOG_BRIDGE
+	NoteSetFnDebugOutput(notecard_log_print);
+#endif
 
-	struct notecard_data *data = dev->data;
-	const struct notecard_config *config = dev->config;
+	/* Set platform specific hooks. */
+	NoteSetFn(notecard_malloc, notecard_free, zephyr_delay, zephyr_millis);
 
 	/* Dev is later required in notecard_delayed_work_handler and attn_pin_cb_handler, cause it
 	 * can not be fetched with CONTAINER_OF macro. */
 	data->dev = dev;
 
+	int rc = config->bus.init(&config->bus);
+	if (rc) {
+		return rc;
+	}
+
+#if CONFIG_NOTECARD_ASYNC
+	rc = notecard_async_init(dev);
+	if (rc) {
+		return rc;
+	}
+#endif
+
+#if CONFIG_NOTECARD_ATTN_DEFERRED
+	if (config->attn_gpio_in_use) {
+		notecard_attn_init(dev);
+	}
+#endif
+
+#if CONFIG_NOTECARD_CACHE
+	notecard_cache_init(dev);
+#endif
+
+#if CONFIG_NOTECARD_QUEUE
+	/* Notecard is usable without the queue, failure only disables it. */
+	notecard_queue_init(dev);
+#endif
+
 	return config->attn_gpio_in_use
 		       ? prv_configure_interrupt_gpio(&data->gpio_cb, &config->attn_p_gpio)
 		       : 0;
 }
 
-void notecard_ctrl_take(const struct device *dev)
+int notecard_ctrl_take_timeout(const struct device *dev, k_timeout_t timeout)
 {
-	k_mutex_lock(&prv_mutex, K_FOREVER);
+	uint32_t start = notecard_stats_now();
+
+	/* Mutex queues waiters by priority and applies priority inheritance to the owner. */
+	int rc = k_mutex_lock(&prv_mutex, timeout);
+	if (rc) {
+		notecard_stats_ctrl_timeout(dev);
+		return rc;
+	}
+
 	struct notecard_data *data = dev->data;
 
+	notecard_stats_latency(dev, NOTECARD_STATS_LOCK_WAIT, start);
+
+	prv_owner = dev;
+	prv_owner_thread = k_current_get();
+	if (prv_owner_depth++ == 0) {
+		prv_owner_since = notecard_stats_now();
+	}
+
 	if (data->post_take_cb_data.cb) {
 		data->post_take_cb_data.cb(dev, data->post_take_cb_data.user_data);
 	}
 
-	const struct notecard_config *config = dev->config;
-	config->bus.attach_bus_api(&config->bus);
+	/* Hooks only need to be swapped when a different instance takes control. */
+	if (prv_attached != dev) {
+		const struct notecard_config *config = dev->config;
+
+		config->bus.attach_bus_api(&config->bus);
+		prv_attached = dev;
+	}
+
+	return 0;
+}
+
+void notecard_ctrl_take(const struct device *dev)
+{
+	notecard_ctrl_take_timeout(dev, K_FOREVER);
 }
 
 void notecard_ctrl_release(const struct device *dev)
@@ -298,44 +243,19 @@ void notecard_ctrl_release(const struct device *dev)
 		data->pre_release_cb_data.cb(dev, data->pre_release_cb_data.user_data);
 	}
 
+	if (--prv_owner_depth == 0) {
+		notecard_stats_latency(dev, NOTECARD_STATS_LOCK_HOLD, prv_owner_since);
+		prv_owner = NULL;
+		prv_owner_thread = NULL;
+	}
 	k_mutex_unlock(&prv_mutex);
 }
 
-size_t notecard_available_memory(void)
+const struct device *notecard_ctrl_owner(void)
 {
-	struct object_header {
-		struct object_header *prev;
-		size_t length;
-	};
-
-	/*  Allocate progressively smaller and smaller chunks */
-	struct object_header *prev_obj = NULL;
-	static size_t max_size = 8192;
-	for (size_t i = max_size; i >= sizeof(struct object_header);
-	     i -= sizeof(struct object_header)) {
-
-		while (1) {
-			struct object_header *obj;
-			obj = k_heap_alloc(&prv_heap, i, K_NO_WAIT);
-			if (obj == NULL) {
-				break;
-			}
-			obj->prev = prev_obj;
-			obj->length = i;
-			prev_obj = obj;
-		}
-	}
-
-	/* Free the objects backwards */
-	size_t total = 0;
-	while (prev_obj) {
-		struct object_header *obj = prev_obj;
-		prev_obj = obj->prev;
-		total += obj->length;
-		k_heap_free(&prv_heap, obj);
-	}
-
-	return total;
+	/* Owner thread is only ever set to the current thread by the current thread, so other
+	 * threads can not mistake themselves for the owner. */
+	return prv_owner_thread == k_current_get() ? prv_owner : NULL;
 }
 
 void notecard_attn_cb_register(const struct device *dev, notecard_cb_t attn_cb, void *user_data)
@@ -380,107 +300,180 @@ void notecard_pre_release_cb_register(const struct device *dev, notecard_cb_t pr
 bool notecard_is_present(const struct device *dev)
 {
 	const struct notecard_config *config = dev->config;
-#if NOTECARD_BUS_UART
-	const struct device *uart = config->bus.dev.uart;
-	int rc;
-	char c;
-
-	/* Clean up any characters left in the uart buffer. */
-	while (!uart_poll_in(uart, &c)) {
-	}
-
-	char *req = "\r\n";
-	for (size_t i = 0; i < strlen(req); ++i) {
-		uart_poll_out(uart, req[i]);
-		/* 100 us delay is needed to prevent overwhelming the nrfx implementation of
-		 * uart_poll_out and entering 1ms sleep between each call. */
-		k_busy_wait(100);
-	}
+	struct notecard_data *data = dev->data;
 
-	/* Wait a bit */
-	k_sleep(K_MSEC(250));
+	data->ready = config->bus.is_present(&config->bus, K_MSEC(CONFIG_NOTECARD_PROBE_TIMEOUT_MS));
 
-	/* Notecard should respond with the same two characters back. */
-	rc = uart_poll_in(uart, &c);
-	if (rc || c != '\r') {
-		/* No character arrived. */
-		return false;
-	}
+	return data->ready;
+}
 
-	rc = uart_poll_in(uart, &c);
-	if (rc || c != '\n') {
-		/* No character arrived. */
-		return false;
-	}
+int notecard_wait_ready(const struct device *dev, k_timeout_t timeout)
+{
+	const struct notecard_config *config = dev->config;
+	struct notecard_data *data = dev->data;
+	k_timepoint_t end = sys_timepoint_calc(timeout);
 
-	return true;
-#endif
-#if NOTECARD_BUS_I2C
-	const struct i2c_dt_spec *i2c = &config->bus.dev.i2c;
+	while (true) {
+		k_timepoint_t probe_end =
+			sys_timepoint_calc(K_MSEC(CONFIG_NOTECARD_PROBE_TIMEOUT_MS));
 
-	struct i2c_msg msgs[1];
-	uint8_t dst[2] = {0x00, 0x00};
+		/* Single check never waits past the overall deadline. */
+		if (sys_timepoint_cmp(end, probe_end) < 0) {
+			probe_end = end;
+		}
 
-#if CONFIG_LOG
+		data->ready = config->bus.is_present(&config->bus, sys_timepoint_timeout(probe_end));
+		if (data->ready) {
+			return 0;
+		}
 
-	/* Disable logging for i2c_nrfx, as we know that it will be noisy, if notecard
-	 * is missing.
-	 *
-	 * Since we do not know whether twi or twim is used, we check both. */
+		if (sys_timepoint_expired(end)) {
+			return -ETIMEDOUT;
+		}
 
-	int16_t source_id = (int16_t)log_source_id_get("i2c_nrfx_twi");
-	if (source_id < 0) {
-		source_id = (int16_t)log_source_id_get("i2c_nrfx_twim");
-	}
-	if (source_id >= 0) {
-		log_filter_set(NULL, 0, source_id, LOG_LEVEL_NONE);
-	} else {
-		/* Some other i2c is being used, do nothing. */
-		LOG_WRN("Could not get source id for i2c_nrfx_twi or i2c_nrfx_twim. Unable to "
-			"disable logging for i2c.");
+		/* Notecard is still booting, or absent, do not hammer the bus. */
+		k_msleep(NOTECARD_PROBE_RETRY_MS);
 	}
+}
 
-#endif
+bool notecard_is_ready(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
 
-	/* Write some data to the notecard to see if you get back response. */
-	msgs[0].buf = dst;
-	msgs[0].len = 2U;
-	msgs[0].flags = I2C_MSG_WRITE | I2C_MSG_STOP;
+	return data->ready;
+}
 
-	bool present = i2c_transfer(i2c->bus, &msgs[0], 1, i2c->addr) == 0;
+int notecard_uart_rx_stats_get(const struct device *dev, struct notecard_uart_rx_stats *stats)
+{
+#if NOTECARD_BUS_UART && CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+	const struct notecard_config *config = dev->config;
+	const struct notecard_uart_data *uart_data = config->bus.data;
 
-	/* Enable back logging. Set the highest level possible, it will be limited by the
-	 * actual compiled in level. */
-#if CONFIG_LOG
-	if (source_id >= 0) {
-		log_filter_set(NULL, 0, source_id, LOG_LEVEL_DBG);
+	if (!uart_data) {
+		/* Instance is not on the uart bus. */
+		return -ENOTSUP;
 	}
-#endif
-	return present;
+
+	stats->received = uart_data->rx_received;
+	stats->ring_overruns = uart_data->rx_dropped;
+	stats->hw_overruns = uart_data->rx_hw_overruns;
+
+	return 0;
+#else
+	ARG_UNUSED(dev);
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
 #endif
 }
 
 #define DT_DRV_COMPAT blues_notecard
 
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+#define NOTECARD_UART_DATA_DEFINE(inst) static struct notecard_uart_data notecard_uart_data_##inst;
+#define NOTECARD_UART_DATA_PTR(inst)    &notecard_uart_data_##inst
+#else
+#define NOTECARD_UART_DATA_DEFINE(inst)
+#define NOTECARD_UART_DATA_PTR(inst) NULL
+#endif
+
+#define NOTECARD_I2C_DATA_DEFINE(inst) static struct notecard_i2c_data notecard_i2c_data_##inst;
+
+#if CONFIG_NOTECARD_RX_WAKE
+#define NOTECARD_UART_RX_WAIT   .rx_wait = notecard_uart_rx_wait,
+#define NOTECARD_REPLAY_RX_WAIT .rx_wait = notecard_replay_rx_wait,
+#else
+#define NOTECARD_UART_RX_WAIT
+#define NOTECARD_REPLAY_RX_WAIT
+#endif
+
 #define NOTECARD_CONFIG_UART(inst)                                                                 \
 	{                                                                                          \
 		.dev.uart = DEVICE_DT_GET(DT_BUS(DT_DRV_INST(inst))),                              \
+		.data = NOTECARD_UART_DATA_PTR(inst),                                              \
+		.init = notecard_uart_init,                                                        \
 		.attach_bus_api = notecard_uart_attach_bus_api,                                    \
+		.is_present = notecard_uart_is_present,                                            \
+		.write = notecard_uart_write,                                                      \
+		.chunk_max_len = NOTECARD_SEGMENT_MAX_LEN,                                         \
+		.chunk_delay_ms = 0,                                                               \
+		.read = notecard_uart_read,                                                        \
+		NOTECARD_UART_RX_WAIT                                                              \
 	}
 
 #define NOTECARD_CONFIG_I2C(inst)                                                                  \
 	{                                                                                          \
 		.dev.i2c = I2C_DT_SPEC_INST_GET(inst),                                             \
+		.data = &notecard_i2c_data_##inst,                                                 \
+		.init = notecard_i2c_init,                                                         \
 		.attach_bus_api = notecard_i2c_attach_bus_api,                                     \
+		.is_present = notecard_i2c_is_present,                                             \
+		.write = notecard_i2c_write,                                                       \
+		.chunk_max_len = NOTE_I2C_MAX_MAX,                                                 \
+		.chunk_delay_ms = NOTECARD_I2C_CHUNK_DELAY_MS,                                     \
+		.read = notecard_i2c_read,                                                         \
+	}
+
+#define NOTECARD_CONFIG_REPLAY(inst)                                                               \
+	{                                                                                          \
+		.data = NULL,                                                                      \
+		.init = notecard_replay_init,                                                      \
+		.attach_bus_api = notecard_replay_attach_bus_api,                                  \
+		.is_present = notecard_replay_is_present,                                          \
+		.write = notecard_replay_write,                                                    \
+		.chunk_max_len = NOTECARD_SEGMENT_MAX_LEN,                                         \
+		.chunk_delay_ms = 0,                                                               \
+		.read = notecard_replay_read,                                                      \
+		NOTECARD_REPLAY_RX_WAIT                                                            \
 	}
 
+/* Replay takes the place of the bus that the instance is on in the devicetree. */
+#if CONFIG_NOTECARD_REPLAY
+#define NOTECARD_BUS_DATA_DEFINE(inst)
+#define NOTECARD_CONFIG_BUS(inst) NOTECARD_CONFIG_REPLAY(inst)
+#else
+#define NOTECARD_BUS_DATA_DEFINE(inst)                                                             \
+	COND_CODE_1(DT_INST_ON_BUS(inst, uart), (NOTECARD_UART_DATA_DEFINE(inst)),               \
+		    (NOTECARD_I2C_DATA_DEFINE(inst)))
+#define NOTECARD_CONFIG_BUS(inst)                                                                  \
+	COND_CODE_1(DT_INST_ON_BUS(inst, uart), (NOTECARD_CONFIG_UART(inst)),                      \
+		    (NOTECARD_CONFIG_I2C(inst)))
+#endif
+
+#if CONFIG_NOTECARD_ASYNC
+#define NOTECARD_ASYNC_STACK_DEFINE(inst)                                                          \
+	static K_KERNEL_STACK_DEFINE(notecard_async_stack_##inst,                                  \
+				     CONFIG_NOTECARD_ASYNC_THREAD_STACK_SIZE);
+#define NOTECARD_ASYNC_CONFIG(inst) .async_stack = notecard_async_stack_##inst,
+#else
+#define NOTECARD_ASYNC_STACK_DEFINE(inst)
+#define NOTECARD_ASYNC_CONFIG(inst)
+#endif
+
+#if CONFIG_NOTECARD_QUEUE
+#define NOTECARD_QUEUE_CONFIG(inst)                                                                \
+	.queue_partition_id = COND_CODE_1(                                                         \
+		DT_INST_NODE_HAS_PROP(inst, queue_partition),                                      \
+		(DT_FIXED_PARTITION_ID(DT_INST_PHANDLE(inst, queue_partition))), (-1)),
+#else
+#define NOTECARD_QUEUE_CONFIG(inst)
+#endif
+
 #define NOTECARD_DEFINE(inst)                                                                      \
+	NOTECARD_BUS_DATA_DEFINE(inst)                                                             \
+	NOTECARD_ASYNC_STACK_DEFINE(inst)                                                          \
+                                                                                                   \
+	static uint8_t notecard_heap_buf_##inst[DT_INST_PROP_OR(inst, heap_size,                   \
+								CONFIG_NOTECARD_HEAP_SIZE)];       \
+                                                                                                   \
 	static const struct notecard_config notecard_config_##inst = {                             \
-		.bus = COND_CODE_1(DT_INST_ON_BUS(inst, uart), (NOTECARD_CONFIG_UART(inst)),       \
-				   (NOTECARD_CONFIG_I2C(inst))),                                   \
+		.bus = NOTECARD_CONFIG_BUS(inst),                                                  \
 		.attn_p_gpio = GPIO_DT_SPEC_INST_GET_OR(inst, attn_p_gpios, {}),                   \
-		.attn_gpio_in_use = DT_INST_NODE_HAS_PROP(inst, attn_p_gpios)                      \
-                                                                                                   \
+		.attn_gpio_in_use = DT_INST_NODE_HAS_PROP(inst, attn_p_gpios),                     \
+		.heap_buf = notecard_heap_buf_##inst,                                              \
+		.heap_size = sizeof(notecard_heap_buf_##inst),                                     \
+		NOTECARD_ASYNC_CONFIG(inst)                                                        \
+		NOTECARD_QUEUE_CONFIG(inst)                                                        \
 	};                                                                                         \
                                                                                                    \
 	static struct notecard_data notecard_data_##inst;                                          \
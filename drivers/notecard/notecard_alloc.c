@@ -0,0 +1,368 @@
+/** @file notecard_alloc.c
+ *
+ * @brief Memory allocator used by note-c and cJSON.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* Heaps of all initialized instances, used to find the heap that owns the memory on free. */
+static struct notecard_heap *prv_heaps[DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT)];
+static size_t prv_num_heaps;
+
+/* Heap of allocations of threads without control, first initialized instance unless selected
+ * with notecard_heap_select(). */
+static atomic_ptr_t prv_default_heap = ATOMIC_PTR_INIT(NULL);
+
+#if CONFIG_NOTECARD_ALLOC_SLAB
+
+/* Slab blocks need to be aligned for any type that cJSON stores in them (double). */
+#define SLAB_ALIGN 8
+
+BUILD_ASSERT(CONFIG_NOTECARD_SLAB_SMALL_BLOCK_SIZE % SLAB_ALIGN == 0,
+	     "Small slab block size needs to be a multiple of 8");
+BUILD_ASSERT(CONFIG_NOTECARD_SLAB_MEDIUM_BLOCK_SIZE % SLAB_ALIGN == 0,
+	     "Medium slab block size needs to be a multiple of 8");
+BUILD_ASSERT(CONFIG_NOTECARD_SLAB_SMALL_BLOCK_SIZE < CONFIG_NOTECARD_SLAB_MEDIUM_BLOCK_SIZE,
+	     "Small slab blocks need to be smaller than medium slab blocks");
+
+struct slab_pool {
+	struct k_mem_slab slab;
+	uint8_t *buf;
+	size_t block_size;
+	uint32_t num_blocks;
+
+	/* Counters, protected by prv_pool_lock. */
+	uint32_t max_used;
+	uint32_t hits;
+	uint32_t misses;
+};
+
+static uint8_t __aligned(SLAB_ALIGN)
+	prv_small_buf[CONFIG_NOTECARD_SLAB_SMALL_BLOCK_SIZE * CONFIG_NOTECARD_SLAB_SMALL_BLOCK_COUNT];
+static uint8_t __aligned(SLAB_ALIGN) prv_medium_buf[CONFIG_NOTECARD_SLAB_MEDIUM_BLOCK_SIZE *
+						    CONFIG_NOTECARD_SLAB_MEDIUM_BLOCK_COUNT];
+
+/* Pools sorted by block size, smallest first. */
+static struct slab_pool prv_pools[] = {
+	{
+		.buf = prv_small_buf,
+		.block_size = CONFIG_NOTECARD_SLAB_SMALL_BLOCK_SIZE,
+		.num_blocks = CONFIG_NOTECARD_SLAB_SMALL_BLOCK_COUNT,
+	},
+	{
+		.buf = prv_medium_buf,
+		.block_size = CONFIG_NOTECARD_SLAB_MEDIUM_BLOCK_SIZE,
+		.num_blocks = CONFIG_NOTECARD_SLAB_MEDIUM_BLOCK_COUNT,
+	},
+};
+
+static struct k_spinlock prv_pool_lock;
+
+/**
+ * @brief Try to serve allocation from the smallest pool that fits it.
+ *
+ * @return Allocated block or NULL, if allocation needs to fall back to the heap.
+ */
+static void *prv_pool_alloc(size_t size)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(prv_pools); i++) {
+		struct slab_pool *pool = &prv_pools[i];
+
+		if (size > pool->block_size) {
+			continue;
+		}
+
+		void *ptr;
+		bool hit = k_mem_slab_alloc(&pool->slab, &ptr, K_NO_WAIT) == 0;
+
+		K_SPINLOCK(&prv_pool_lock) {
+			if (hit) {
+				pool->hits++;
+				pool->max_used =
+					MAX(pool->max_used, k_mem_slab_num_used_get(&pool->slab));
+			} else {
+				pool->misses++;
+			}
+		}
+
+		/* Only the best fitting pool is tried, larger blocks are left for larger
+		 * allocations. */
+		return hit ? ptr : NULL;
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Get pool that owns the given memory.
+ *
+ * @return Pool or NULL, if memory was allocated from the heap.
+ */
+static struct slab_pool *prv_pool_get(void *mem)
+{
+	uint8_t *ptr = mem;
+
+	for (size_t i = 0; i < ARRAY_SIZE(prv_pools); i++) {
+		struct slab_pool *pool = &prv_pools[i];
+
+		if (ptr >= pool->buf && ptr < pool->buf + pool->block_size * pool->num_blocks) {
+			return pool;
+		}
+	}
+
+	return NULL;
+}
+
+#endif /* CONFIG_NOTECARD_ALLOC_SLAB */
+
+/**
+ * @brief Get heap that owns the given memory.
+ *
+ * @return Heap or NULL, if memory does not belong to any heap.
+ */
+static struct notecard_heap *prv_heap_get(void *mem)
+{
+	uint8_t *ptr = mem;
+
+	for (size_t i = 0; i < prv_num_heaps; i++) {
+		struct notecard_heap *heap = prv_heaps[i];
+
+		if (ptr >= heap->buf && ptr < heap->buf + heap->size) {
+			return heap;
+		}
+	}
+
+	return NULL;
+}
+
+void notecard_alloc_init(struct notecard_heap *heap, uint8_t *buf, size_t size)
+{
+	__ASSERT(prv_num_heaps < ARRAY_SIZE(prv_heaps), "Too many heaps registered");
+
+	heap->buf = buf;
+	heap->size = size;
+	atomic_clear(&heap->num_allocs);
+	atomic_clear(&heap->alloc_failures);
+#if !CONFIG_SYS_HEAP_RUNTIME_STATS
+	atomic_clear(&heap->allocated_bytes);
+#endif
+	k_heap_init(&heap->heap, buf, size);
+
+	prv_heaps[prv_num_heaps++] = heap;
+	atomic_ptr_cas(&prv_default_heap, NULL, heap);
+
+#if CONFIG_NOTECARD_ALLOC_SLAB
+	if (prv_num_heaps > 1) {
+		return;
+	}
+
+	/* Slab pools are shared between all instances, they are initialized only once. */
+	for (size_t i = 0; i < ARRAY_SIZE(prv_pools); i++) {
+		struct slab_pool *pool = &prv_pools[i];
+
+		k_mem_slab_init(&pool->slab, pool->buf, pool->block_size, pool->num_blocks);
+	}
+#endif
+}
+
+void notecard_heap_select(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+
+	atomic_ptr_set(&prv_default_heap, &data->heap);
+}
+
+/**
+ * @brief Get heap that the calling thread allocates from.
+ *
+ * Requests and responses of a thread with control belong to that instance, so it can not draw
+ * from the heap of a card that another thread is using. Threads without control (e.g. building a
+ * request before taking control or submitting it) use the default heap.
+ */
+static struct notecard_heap *prv_heap_current(void)
+{
+	const struct device *owner = notecard_ctrl_owner();
+
+	if (owner) {
+		struct notecard_data *data = owner->data;
+
+		return &data->heap;
+	}
+
+	return atomic_ptr_get(&prv_default_heap);
+}
+
+void *notecard_malloc(size_t size)
+{
+	void *ptr;
+
+#if CONFIG_NOTECARD_ALLOC_SLAB
+	ptr = prv_pool_alloc(size);
+	if (ptr) {
+		return ptr;
+	}
+#endif
+
+	struct notecard_heap *heap = prv_heap_current();
+
+	if (!heap) {
+		LOG_ERR("Allocation before any notecard was initialized");
+		return NULL;
+	}
+
+	ptr = k_heap_alloc(&heap->heap, size, K_NO_WAIT);
+	if (!ptr) {
+		atomic_inc(&heap->alloc_failures);
+		LOG_ERR("Memory allocation failed!");
+		return NULL;
+	}
+
+	atomic_inc(&heap->num_allocs);
+#if !CONFIG_SYS_HEAP_RUNTIME_STATS
+	atomic_add(&heap->allocated_bytes, sys_heap_usable_size(&heap->heap.heap, ptr));
+#endif
+
+	return ptr;
+}
+
+void notecard_free(void *mem)
+{
+	if (!mem) {
+		return;
+	}
+
+#if CONFIG_NOTECARD_ALLOC_SLAB
+	struct slab_pool *pool = prv_pool_get(mem);
+	if (pool) {
+		k_mem_slab_free(&pool->slab, mem);
+		return;
+	}
+#endif
+
+	/* Memory might have been allocated by a thread that had control of another instance. */
+	struct notecard_heap *heap = prv_heap_get(mem);
+	if (!heap) {
+		LOG_ERR("Freeing memory that was not allocated by notecard: %p", mem);
+		return;
+	}
+
+#if !CONFIG_SYS_HEAP_RUNTIME_STATS
+	atomic_sub(&heap->allocated_bytes, sys_heap_usable_size(&heap->heap.heap, mem));
+#endif
+	k_heap_free(&heap->heap, mem);
+	atomic_dec(&heap->num_allocs);
+}
+
+int notecard_slab_stats_get(size_t pool_idx, struct notecard_slab_stats *stats)
+{
+#if CONFIG_NOTECARD_ALLOC_SLAB
+	if (pool_idx >= ARRAY_SIZE(prv_pools)) {
+		return -EINVAL;
+	}
+
+	struct slab_pool *pool = &prv_pools[pool_idx];
+
+	K_SPINLOCK(&prv_pool_lock) {
+		stats->block_size = pool->block_size;
+		stats->num_blocks = pool->num_blocks;
+		stats->num_used = k_mem_slab_num_used_get(&pool->slab);
+		stats->max_used = pool->max_used;
+		stats->hits = pool->hits;
+		stats->misses = pool->misses;
+	}
+
+	return 0;
+#else
+	ARG_UNUSED(pool_idx);
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+#endif
+}
+
+#if CONFIG_NOTECARD_MEM_STATS
+/**
+ * @brief Get statistics of the given heap.
+ */
+static int prv_heap_stats_get(struct notecard_heap *heap, struct notecard_mem_stats *stats)
+{
+	struct sys_memory_stats heap_stats;
+
+	/* Only copies the counters that the heap maintains on every alloc/free. */
+	int rc = sys_heap_runtime_stats_get(&heap->heap.heap, &heap_stats);
+	if (rc) {
+		return rc;
+	}
+
+	uint32_t num_allocs = atomic_get(&heap->num_allocs);
+
+	stats->free_bytes = heap_stats.free_bytes;
+	stats->allocated_bytes = heap_stats.allocated_bytes;
+	stats->max_allocated_bytes = heap_stats.max_allocated_bytes;
+	stats->num_allocs = num_allocs;
+	stats->alloc_failures = atomic_get(&heap->alloc_failures);
+
+	/* Adjacent free chunks are always merged, so free memory is split into at most one region
+	 * more than there are live allocations. Largest of those regions is at least their
+	 * average size. */
+	stats->largest_free_min = heap_stats.free_bytes / (num_allocs + 1);
+
+	return 0;
+}
+#endif /* CONFIG_NOTECARD_MEM_STATS */
+
+int notecard_mem_stats_get(const struct device *dev, struct notecard_mem_stats *stats)
+{
+#if CONFIG_NOTECARD_MEM_STATS
+	struct notecard_data *data = dev->data;
+
+	return prv_heap_stats_get(&data->heap, stats);
+#else
+	ARG_UNUSED(dev);
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+#endif
+}
+
+/**
+ * @brief Get number of free bytes in the given heap.
+ */
+static size_t prv_heap_free_bytes(struct notecard_heap *heap)
+{
+#if CONFIG_SYS_HEAP_RUNTIME_STATS
+	struct sys_memory_stats heap_stats;
+
+	if (sys_heap_runtime_stats_get(&heap->heap.heap, &heap_stats)) {
+		return 0;
+	}
+
+	return heap_stats.free_bytes;
+#else
+	/* Chunk headers are not counted, so this is slightly more than what can be allocated. */
+	return heap->size - MIN(heap->size, (size_t)atomic_get(&heap->allocated_bytes));
+#endif
+}
+
+size_t notecard_available_memory(void)
+{
+	size_t total = 0;
+
+	for (size_t i = 0; i < prv_num_heaps; i++) {
+		total += prv_heap_free_bytes(prv_heaps[i]);
+	}
+
+	return total;
+}
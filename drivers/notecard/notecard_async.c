@@ -0,0 +1,185 @@
+/** @file notecard_async.c
+ *
+ * @brief Asynchronous request API, executed by a per-instance worker thread.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/__assert.h>
+
+#include <note.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+#if CONFIG_NOTECARD_ASYNC_QUEUE_FULL_DROP_OLDEST
+/**
+ * @brief Call callbacks of all dropped requests.
+ */
+static void prv_complete_dropped(const struct device *dev, struct notecard_data *data)
+{
+	struct notecard_async_req item;
+
+	while (k_msgq_get(&data->async.dropped, &item, K_NO_WAIT) == 0) {
+		item.cb(dev, NULL, item.user_data);
+	}
+}
+#endif
+
+/**
+ * @brief Worker thread, executes queued requests.
+ *
+ * Control is taken once for the first request and released only when the queue is empty, so
+ * requests that are queued in a burst are executed back-to-back.
+ */
+static void prv_worker(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	const struct device *dev = p1;
+	struct notecard_data *data = dev->data;
+	struct notecard_async_req item;
+
+#if CONFIG_NOTECARD_ASYNC_QUEUE_FULL_DROP_OLDEST
+	struct k_poll_event events[] = {
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+					 &data->async.queue),
+		K_POLL_EVENT_INITIALIZER(K_POLL_TYPE_MSGQ_DATA_AVAILABLE, K_POLL_MODE_NOTIFY_ONLY,
+					 &data->async.dropped),
+	};
+#endif
+
+	while (true) {
+#if CONFIG_NOTECARD_ASYNC_QUEUE_FULL_DROP_OLDEST
+		k_poll(events, ARRAY_SIZE(events), K_FOREVER);
+		events[0].state = K_POLL_STATE_NOT_READY;
+		events[1].state = K_POLL_STATE_NOT_READY;
+
+		prv_complete_dropped(dev, data);
+
+		if (k_msgq_get(&data->async.queue, &item, K_NO_WAIT) != 0) {
+			continue;
+		}
+#else
+		k_msgq_get(&data->async.queue, &item, K_FOREVER);
+#endif
+
+		notecard_ctrl_take(dev);
+
+		do {
+			J *rsp = NoteRequestResponse(item.req);
+
+			if (item.cb) {
+				item.cb(dev, rsp, item.user_data);
+			} else {
+				NoteDeleteResponse(rsp);
+			}
+
+#if CONFIG_NOTECARD_ASYNC_QUEUE_FULL_DROP_OLDEST
+			/* Requests can be dropped while the worker is busy with a burst. */
+			prv_complete_dropped(dev, data);
+#endif
+		} while (k_msgq_get(&data->async.queue, &item, K_NO_WAIT) == 0);
+
+		notecard_ctrl_release(dev);
+	}
+}
+
+/**
+ * @brief Callback used by notecard_request_submit_signal().
+ */
+static void prv_signal_cb(const struct device *dev, J *rsp, void *user_data)
+{
+	ARG_UNUSED(dev);
+
+	struct notecard_async_rsp *async_rsp = user_data;
+
+	async_rsp->rsp = rsp;
+	k_poll_signal_raise(&async_rsp->signal, rsp ? 0 : -EIO);
+}
+
+int notecard_request_submit(const struct device *dev, J *req, notecard_rsp_cb_t rsp_cb,
+			    void *user_data)
+{
+	__ASSERT(req, "Request needs to be provided");
+
+	struct notecard_data *data = dev->data;
+	struct notecard_async_req item = {
+		.req = req,
+		.cb = rsp_cb,
+		.user_data = user_data,
+	};
+
+	while (k_msgq_put(&data->async.queue, &item, K_NO_WAIT) != 0) {
+#if CONFIG_NOTECARD_ASYNC_QUEUE_FULL_DROP_OLDEST
+		struct notecard_async_req oldest;
+
+		/* Callback of the dropped request is called by the worker, so there needs to be
+		 * space to report it. */
+		if (k_msgq_num_free_get(&data->async.dropped) == 0) {
+			LOG_WRN("Request queue full, rejecting request");
+			return -ENOBUFS;
+		}
+
+		/* Worker might have emptied the queue in the meantime, in that case just retry. */
+		if (k_msgq_get(&data->async.queue, &oldest, K_NO_WAIT) == 0) {
+			LOG_WRN("Request queue full, dropping oldest request");
+			JDelete(oldest.req);
+
+			if (oldest.cb) {
+				oldest.req = NULL;
+				/* Free space was checked above, this can only fail when another
+				 * thread dropped a request in the meantime. */
+				if (k_msgq_put(&data->async.dropped, &oldest, K_NO_WAIT) != 0) {
+					LOG_ERR("Dropped request could not be reported");
+				}
+			}
+		}
+#else
+		LOG_WRN("Request queue full, rejecting request");
+		return -ENOBUFS;
+#endif
+	}
+
+	return 0;
+}
+
+int notecard_request_submit_signal(const struct device *dev, J *req,
+				   struct notecard_async_rsp *async_rsp)
+{
+	__ASSERT(async_rsp, "Response container needs to be provided");
+
+	async_rsp->rsp = NULL;
+	k_poll_signal_init(&async_rsp->signal);
+
+	return notecard_request_submit(dev, req, prv_signal_cb, async_rsp);
+}
+
+int notecard_async_init(const struct device *dev)
+{
+	const struct notecard_config *config = dev->config;
+	struct notecard_data *data = dev->data;
+
+	k_msgq_init(&data->async.queue, data->async.queue_buf, sizeof(struct notecard_async_req),
+		    CONFIG_NOTECARD_ASYNC_QUEUE_DEPTH);
+#if CONFIG_NOTECARD_ASYNC_QUEUE_FULL_DROP_OLDEST
+	k_msgq_init(&data->async.dropped, data->async.dropped_buf,
+		    sizeof(struct notecard_async_req), CONFIG_NOTECARD_ASYNC_QUEUE_DEPTH);
+#endif
+
+	k_tid_t tid = k_thread_create(&data->async.thread, config->async_stack,
+				      CONFIG_NOTECARD_ASYNC_THREAD_STACK_SIZE, prv_worker,
+				      (void *)dev, NULL, NULL,
+				      K_PRIO_PREEMPT(CONFIG_NOTECARD_ASYNC_THREAD_PRIORITY), 0,
+				      K_NO_WAIT);
+	k_thread_name_set(tid, dev->name);
+
+	return 0;
+}
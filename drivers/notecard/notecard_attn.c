@@ -0,0 +1,123 @@
+/** @file notecard_attn.c
+ *
+ * @brief Deferred dispatch of attn pin events through a workqueue.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+#if CONFIG_NOTECARD_ATTN_WORKQ
+static K_KERNEL_STACK_DEFINE(prv_attn_workq_stack, CONFIG_NOTECARD_ATTN_WORKQ_STACK_SIZE);
+static struct k_work_q prv_attn_workq;
+#endif
+
+/**
+ * @brief Get the workqueue that attn events are dispatched from by default.
+ *
+ * Dedicated workqueue is shared between all instances and is started by the first one.
+ */
+static struct k_work_q *prv_default_workq(void)
+{
+#if CONFIG_NOTECARD_ATTN_WORKQ
+	static bool started;
+
+	if (!started) {
+		struct k_work_queue_config cfg = {
+			.name = "notecard_attn",
+		};
+
+		k_work_queue_start(&prv_attn_workq, prv_attn_workq_stack,
+				   K_KERNEL_STACK_SIZEOF(prv_attn_workq_stack),
+				   K_PRIO_PREEMPT(CONFIG_NOTECARD_ATTN_WORKQ_PRIORITY), &cfg);
+		started = true;
+	}
+
+	return &prv_attn_workq;
+#else
+	return &k_sys_work_q;
+#endif
+}
+
+/**
+ * @brief Work handler, calls the registered attn callback outside of the interrupt context.
+ *
+ * All attn events that fired since the last run are coalesced into a single call.
+ */
+static void prv_attn_work_handler(struct k_work *work)
+{
+	struct notecard_attn_data *attn = CONTAINER_OF(work, struct notecard_attn_data, work);
+	struct notecard_data *data = CONTAINER_OF(attn, struct notecard_data, attn);
+	uint32_t count = atomic_clear(&attn->pending);
+
+	if (count == 0) {
+		return;
+	}
+
+	K_SPINLOCK(&attn->lock) {
+		attn->event.count = count;
+		attn->event.timestamp = attn->last_timestamp;
+	}
+
+	if (data->attn_cb_data.cb) {
+		data->attn_cb_data.cb(data->dev, data->attn_cb_data.user_data);
+	}
+}
+
+void notecard_attn_init(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_attn_data *attn = &data->attn;
+
+	k_work_init(&attn->work, prv_attn_work_handler);
+	k_poll_signal_init(&attn->signal);
+	atomic_clear(&attn->pending);
+	attn->workq = prv_default_workq();
+}
+
+void notecard_attn_dispatch(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_attn_data *attn = &data->attn;
+	uint32_t count = atomic_inc(&attn->pending) + 1;
+
+	K_SPINLOCK(&attn->lock) {
+		attn->last_timestamp = k_uptime_get();
+	}
+
+	/* Waiting threads are woken up right away, the callback runs later on the workqueue. If
+	 * the work is still pending, this event is coalesced into it. */
+	k_poll_signal_raise(&attn->signal, (int)count);
+	k_work_submit_to_queue(attn->workq, &attn->work);
+}
+
+void notecard_attn_workq_set(const struct device *dev, struct k_work_q *workq)
+{
+	struct notecard_data *data = dev->data;
+
+	data->attn.workq = workq ? workq : prv_default_workq();
+}
+
+struct k_poll_signal *notecard_attn_signal_get(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+
+	return &data->attn.signal;
+}
+
+void notecard_attn_event_get(const struct device *dev, struct notecard_attn_event *event)
+{
+	struct notecard_data *data = dev->data;
+
+	K_SPINLOCK(&data->attn.lock) {
+		*event = data->attn.event;
+	}
+}
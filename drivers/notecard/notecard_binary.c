@@ -0,0 +1,454 @@
+/** @file notecard_binary.c
+ *
+ * @brief Binary transfers to and from the notecard's binary storage area (card.binary).
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/__assert.h>
+#include <zephyr/sys/printk.h>
+
+#include <note.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* Binary data is COBS encoded and every encoded byte is XOR-ed with the newline, so the data
+ * contains no newlines and can be terminated with one. */
+#define COBS_EOP       '\n'
+#define COBS_BLOCK_MAX 254
+
+/**
+ * @brief Get length of the next COBS block, i.e. number of non-zero bytes before the next zero.
+ */
+static size_t prv_cobs_block_len(const uint8_t *data, size_t len)
+{
+	size_t n = 0;
+
+	while (n < len && n < COBS_BLOCK_MAX && data[n] != 0) {
+		n++;
+	}
+
+	return n;
+}
+
+/**
+ * @brief Move to the next COBS block.
+ *
+ * @return false if the whole data was encoded.
+ */
+static bool prv_cobs_block_next(struct notecard_cobs_encoder *enc)
+{
+	enc->pos += enc->block_len;
+
+	if (enc->pos == enc->len) {
+		return false;
+	}
+	/* Zero after the block is replaced by the code byte of the next one. Full block is not
+	 * followed by a zero. */
+	if (enc->block_len < COBS_BLOCK_MAX) {
+		enc->pos++;
+	}
+
+	enc->block_len = prv_cobs_block_len(&enc->data[enc->pos], enc->len - enc->pos);
+	enc->block_pos = 0;
+
+	return true;
+}
+
+void notecard_cobs_encoder_init(struct notecard_cobs_encoder *enc, const uint8_t *data,
+				size_t len)
+{
+	__ASSERT(data || len == 0, "Data needs to be provided");
+
+	enc->data = data;
+	enc->len = len;
+	enc->pos = 0;
+	enc->block_len = prv_cobs_block_len(data, len);
+	enc->block_pos = 0;
+	enc->done = false;
+}
+
+size_t notecard_cobs_encode(struct notecard_cobs_encoder *enc, uint8_t *out, size_t size)
+{
+	size_t n = 0;
+
+	while (n < size && !enc->done) {
+		if (enc->block_pos > enc->block_len && !prv_cobs_block_next(enc)) {
+			out[n++] = COBS_EOP;
+			enc->done = true;
+			break;
+		}
+
+		/* Code byte, followed by the non-zero bytes of the block. */
+		uint8_t c = enc->block_pos == 0 ? enc->block_len + 1
+						: enc->data[enc->pos + enc->block_pos - 1];
+
+		out[n++] = c ^ COBS_EOP;
+		enc->block_pos++;
+	}
+
+	return n;
+}
+
+size_t notecard_cobs_encoded_len(const uint8_t *data, size_t len)
+{
+	struct notecard_cobs_encoder enc;
+	size_t encoded_len = 0;
+
+	notecard_cobs_encoder_init(&enc, data, len);
+
+	/* Non-zero bytes of every block plus one code byte, that replaces the zero after it. */
+	do {
+		encoded_len += enc.block_len + 1;
+	} while (prv_cobs_block_next(&enc));
+
+	return encoded_len;
+}
+
+void notecard_cobs_decoder_init(struct notecard_cobs_decoder *dec, uint8_t *buf, size_t size)
+{
+	dec->buf = buf;
+	dec->size = size;
+	dec->len = 0;
+	dec->block_left = 0;
+	dec->zero_pending = false;
+}
+
+int notecard_cobs_decode(struct notecard_cobs_decoder *dec, uint8_t c)
+{
+	c ^= COBS_EOP;
+
+	if (dec->block_left == 0) {
+		/* Code byte, zero that it replaces is only output if another block follows. */
+		if (c == 0) {
+			return -EBADMSG;
+		}
+		if (dec->zero_pending) {
+			if (dec->len == dec->size) {
+				return -EMSGSIZE;
+			}
+			dec->buf[dec->len++] = 0;
+		}
+		dec->block_left = c - 1;
+		dec->zero_pending = c != COBS_BLOCK_MAX + 1;
+		return 0;
+	}
+
+	if (dec->len == dec->size) {
+		return -EMSGSIZE;
+	}
+	dec->buf[dec->len++] = c;
+	dec->block_left--;
+
+	return 0;
+}
+
+int notecard_cobs_decoder_finish(struct notecard_cobs_decoder *dec)
+{
+	return dec->block_left ? -EBADMSG : (int)dec->len;
+}
+
+/**
+ * @brief Calculate MD5 of the data, as a hex string.
+ */
+static void prv_md5_str(const uint8_t *data, size_t len, char *md5_str)
+{
+	NoteMD5Context ctx;
+	uint8_t md5[NOTE_MD5_HASH_SIZE];
+
+	NoteMD5Init(&ctx);
+	NoteMD5Update(&ctx, data, len);
+	NoteMD5Final(md5, &ctx);
+	NoteMD5HashToString(md5, md5_str, NOTE_MD5_HASH_STRING_SIZE);
+}
+
+/**
+ * @brief Encode data with COBS and transmit it, without holding the encoded data in memory.
+ */
+static int prv_cobs_write(struct notecard_transport *tp, const uint8_t *data, size_t len)
+{
+	struct notecard_cobs_encoder enc;
+	uint8_t out[64];
+	size_t n;
+
+	notecard_cobs_encoder_init(&enc, data, len);
+
+	while ((n = notecard_cobs_encode(&enc, out, sizeof(out))) > 0) {
+		int rc = notecard_transport_write(tp, out, n);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Buffered receiver, bytes that are read from the bus past the end of a line are kept
+ * for the next read.
+ */
+struct binary_rx {
+	struct notecard_transport *tp;
+	k_timepoint_t end;
+	uint8_t buf[32];
+	size_t pos;
+	size_t len;
+};
+
+static int prv_rx_get(struct binary_rx *rx, uint8_t *c)
+{
+	while (rx->pos == rx->len) {
+		int rc = notecard_transport_read(rx->tp, rx->buf, sizeof(rx->buf));
+		if (rc < 0) {
+			return rc;
+		}
+
+		if (rc == 0) {
+			if (sys_timepoint_expired(rx->end)) {
+				return -ETIMEDOUT;
+			}
+			k_msleep(NOTECARD_RX_POLL_MS);
+		}
+
+		rx->pos = 0;
+		rx->len = rc;
+	}
+
+	*c = rx->buf[rx->pos++];
+
+	return 0;
+}
+
+/**
+ * @brief Read a line, line that does not fit into the buffer is truncated.
+ */
+static int prv_rx_line(struct binary_rx *rx, char *line, size_t size)
+{
+	size_t len = 0;
+	uint8_t c;
+	int rc;
+
+	while ((rc = prv_rx_get(rx, &c)) == 0 && c != '\n') {
+		if (len < size - 1) {
+			line[len++] = c;
+		}
+	}
+
+	line[len] = '\0';
+
+	return rc;
+}
+
+/**
+ * @brief Receive COBS encoded data and decode it directly into the given buffer.
+ *
+ * @return Number of decoded bytes or negative error code.
+ */
+static int prv_cobs_read(struct binary_rx *rx, uint8_t *buf, size_t size)
+{
+	struct notecard_cobs_decoder dec;
+	uint8_t c;
+	int rc;
+
+	notecard_cobs_decoder_init(&dec, buf, size);
+
+	while ((rc = prv_rx_get(rx, &c)) == 0 && c != COBS_EOP) {
+		rc = notecard_cobs_decode(&dec, c);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return rc ? rc : notecard_cobs_decoder_finish(&dec);
+}
+
+/**
+ * @brief Get a string field from a response line, without parsing the whole response.
+ */
+static bool prv_rsp_string_get(const char *rsp, const char *key, char *value, size_t size)
+{
+	char pattern[16];
+
+	snprintk(pattern, sizeof(pattern), "\"%s\":\"", key);
+
+	const char *start = strstr(rsp, pattern);
+	if (!start) {
+		return false;
+	}
+
+	start += strlen(pattern);
+
+	const char *end = strchr(start, '"');
+	if (!end || (size_t)(end - start) >= size) {
+		return false;
+	}
+
+	memcpy(value, start, end - start);
+	value[end - start] = '\0';
+
+	return true;
+}
+
+static int prv_put_chunk(struct notecard_transport *tp, size_t offset, const uint8_t *data,
+			 size_t len)
+{
+	char md5_str[NOTE_MD5_HASH_STRING_SIZE];
+	char line[128];
+
+	prv_md5_str(data, len, md5_str);
+
+	int n = snprintk(line, sizeof(line),
+			 "{\"req\":\"card.binary.put\",\"cobs\":%zu,\"status\":\"%s\",\"offset\":%zu}\n",
+			 notecard_cobs_encoded_len(data, len), md5_str, offset);
+
+	/* Binary data follows the request right away, notecard responds once it receives it. */
+	int rc = notecard_transport_write(tp, line, n);
+	if (!rc) {
+		rc = prv_cobs_write(tp, data, len);
+	}
+	if (rc) {
+		return rc;
+	}
+
+	rc = notecard_transport_read_line(tp, line, sizeof(line),
+					  K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+	if (rc < 0 && rc != -EMSGSIZE) {
+		return rc;
+	}
+
+	if (strstr(line, "\"err\"")) {
+		LOG_ERR("card.binary.put failed: %s", line);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static int prv_get_chunk(struct notecard_transport *tp, size_t offset, uint8_t *buf, size_t len)
+{
+	char line[128];
+	char md5_str[NOTE_MD5_HASH_STRING_SIZE];
+	char status[NOTE_MD5_HASH_STRING_SIZE];
+
+	int n = snprintk(line, sizeof(line),
+			 "{\"req\":\"card.binary.get\",\"offset\":%zu,\"length\":%zu}\n", offset, len);
+
+	int rc = notecard_transport_write(tp, line, n);
+	if (rc) {
+		return rc;
+	}
+
+	struct binary_rx rx = {
+		.tp = tp,
+		.end = sys_timepoint_calc(K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS)),
+	};
+
+	/* Response is followed by the binary data, unless it is an error. */
+	rc = prv_rx_line(&rx, line, sizeof(line));
+	if (rc) {
+		return rc;
+	}
+
+	if (strstr(line, "\"err\"") || !prv_rsp_string_get(line, "status", status, sizeof(status))) {
+		LOG_ERR("card.binary.get failed: %s", line);
+		return -EIO;
+	}
+
+	rc = prv_cobs_read(&rx, buf, len);
+	if (rc < 0) {
+		return rc;
+	}
+
+	if ((size_t)rc != len) {
+		LOG_ERR("Received %d bytes instead of %zu", rc, len);
+		return -EIO;
+	}
+
+	prv_md5_str(buf, len, md5_str);
+
+	if (strcmp(md5_str, status) != 0) {
+		LOG_ERR("MD5 of the received data does not match");
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static void prv_stats_fill(struct notecard_binary_stats *stats, size_t len, int64_t start)
+{
+	if (!stats) {
+		return;
+	}
+
+	int64_t duration_ms = k_uptime_get() - start;
+
+	stats->bytes = len;
+	stats->duration_ms = (uint32_t)duration_ms;
+	stats->bytes_per_sec = duration_ms ? (uint32_t)((len * 1000ULL) / duration_ms) : 0;
+}
+
+int notecard_binary_put(const struct device *dev, size_t offset, const void *data, size_t len,
+			struct notecard_binary_stats *stats)
+{
+	__ASSERT(data || len == 0, "Data needs to be provided");
+
+	struct notecard_transport tp;
+	const uint8_t *ptr = data;
+	int64_t start = k_uptime_get();
+
+	notecard_transport_init(&tp, dev);
+
+	for (size_t pos = 0; pos < len; pos += CONFIG_NOTECARD_BINARY_CHUNK_SIZE) {
+		size_t n = MIN(len - pos, CONFIG_NOTECARD_BINARY_CHUNK_SIZE);
+
+		int rc = prv_put_chunk(&tp, offset + pos, &ptr[pos], n);
+		if (rc) {
+			LOG_ERR("Failed to put chunk at offset %zu (err=%d)", offset + pos, rc);
+			return rc;
+		}
+
+		/* Every request starts a new segment. */
+		tp.segment_len = 0;
+	}
+
+	prv_stats_fill(stats, len, start);
+
+	return 0;
+}
+
+int notecard_binary_get(const struct device *dev, size_t offset, void *buf, size_t len,
+			struct notecard_binary_stats *stats)
+{
+	__ASSERT(buf || len == 0, "Buffer needs to be provided");
+
+	struct notecard_transport tp;
+	uint8_t *ptr = buf;
+	int64_t start = k_uptime_get();
+
+	notecard_transport_init(&tp, dev);
+
+	for (size_t pos = 0; pos < len; pos += CONFIG_NOTECARD_BINARY_CHUNK_SIZE) {
+		size_t n = MIN(len - pos, CONFIG_NOTECARD_BINARY_CHUNK_SIZE);
+
+		int rc = prv_get_chunk(&tp, offset + pos, &ptr[pos], n);
+		if (rc) {
+			LOG_ERR("Failed to get chunk at offset %zu (err=%d)", offset + pos, rc);
+			return rc;
+		}
+
+		tp.segment_len = 0;
+	}
+
+	prv_stats_fill(stats, len, start);
+
+	return 0;
+}
@@ -0,0 +1,339 @@
+/** @file notecard_cache.c
+ *
+ * @brief Cache of responses to queries that rarely change.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+struct cache_ttl {
+	const char *name;
+	uint32_t ttl_ms;
+};
+
+static const struct cache_ttl prv_ttls[] = {
+	{"card.version", CONFIG_NOTECARD_CACHE_TTL_CARD_VERSION_MS},
+	{"card.status", CONFIG_NOTECARD_CACHE_TTL_CARD_STATUS_MS},
+	{"hub.get", CONFIG_NOTECARD_CACHE_TTL_HUB_GET_MS},
+	{"card.time", CONFIG_NOTECARD_CACHE_TTL_CARD_TIME_MS},
+};
+
+/**
+ * @brief Check if the request has the given name.
+ */
+static bool prv_name_matches(const char *req, const char *name)
+{
+	const char *start = strstr(req, "\"req\":\"");
+
+	if (!start) {
+		return false;
+	}
+
+	start += strlen("\"req\":\"");
+
+	size_t len = strlen(name);
+
+	return strncmp(start, name, len) == 0 && start[len] == '"';
+}
+
+/**
+ * @brief Get time to live of responses to the request.
+ */
+static uint32_t prv_ttl_get(const char *req)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(prv_ttls); i++) {
+		if (prv_name_matches(req, prv_ttls[i].name)) {
+			return prv_ttls[i].ttl_ms;
+		}
+	}
+
+	return CONFIG_NOTECARD_CACHE_TTL_DEFAULT_MS;
+}
+
+/**
+ * @brief Find a valid entry of the request, caller needs to hold the cache lock.
+ */
+static struct notecard_cache_entry *prv_entry_find(struct notecard_cache_data *cache,
+						   const char *req)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cache->entries); i++) {
+		struct notecard_cache_entry *entry = &cache->entries[i];
+
+		if (entry->req[0] != '\0' && strcmp(entry->req, req) == 0 &&
+		    !sys_timepoint_expired(entry->expires)) {
+			return entry;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief Get entry to store the response into, caller needs to hold the cache lock.
+ *
+ * Entry of the same request is reused, otherwise an unused one, otherwise the one that expires
+ * first.
+ */
+static struct notecard_cache_entry *prv_entry_get(struct notecard_cache_data *cache,
+						  const char *req)
+{
+	struct notecard_cache_entry *victim = &cache->entries[0];
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache->entries); i++) {
+		struct notecard_cache_entry *entry = &cache->entries[i];
+
+		if (entry->req[0] == '\0' || strcmp(entry->req, req) == 0) {
+			return entry;
+		}
+
+		if (sys_timepoint_cmp(entry->expires, victim->expires) < 0) {
+			victim = entry;
+		}
+	}
+
+	return victim;
+}
+
+/**
+ * @brief Send the request to the notecard and read its response.
+ */
+static int prv_request(const struct device *dev, const char *req, char *rsp, size_t rsp_size)
+{
+	struct notecard_transport tp;
+
+	notecard_ctrl_take(dev);
+	notecard_transport_init(&tp, dev);
+
+	int rc = notecard_transport_write(&tp, req, strlen(req));
+	if (!rc) {
+		rc = notecard_transport_write(&tp, "\n", 1);
+	}
+	if (!rc) {
+		rc = notecard_transport_read_line(&tp, rsp, rsp_size,
+						  K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+	}
+
+	notecard_ctrl_release(dev);
+
+	if (rc < 0) {
+		LOG_ERR("Failed to send cached request (err=%d)", rc);
+		return rc;
+	}
+
+	return 0;
+}
+
+#if CONFIG_NOTECARD_CACHE_COALESCE_SLOTS
+/**
+ * @brief Send the request, or share the response of the same request that is already in flight.
+ *
+ * First thread that sends the request puts it into a free flight slot, threads that send the same
+ * request meanwhile wait for it to be done and copy its response. Response is copied into the
+ * slot, so the first thread returns right away and the last thread that copies it frees the
+ * slot. Waiting threads send the request themselves if the response does not fit into the slot.
+ *
+ * @param[out] shared	Set if the response was shared from another thread.
+ */
+static int prv_request_coalesced(const struct device *dev, const char *req, char *rsp,
+				 size_t rsp_size, bool *shared)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_cache_data *cache = &data->cache;
+	struct notecard_cache_flight *flight = NULL;
+	struct notecard_cache_flight *free_flight = NULL;
+	int rc;
+
+	k_mutex_lock(&cache->flight_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache->flights); i++) {
+		struct notecard_cache_flight *f = &cache->flights[i];
+
+		if (f->refs == 0) {
+			free_flight = free_flight ? free_flight : f;
+		} else if (f->req && strcmp(f->req, req) == 0) {
+			flight = f;
+			break;
+		}
+	}
+
+	if (flight) {
+		flight->refs++;
+
+		while (!flight->done) {
+			k_condvar_wait(&cache->flight_cond, &cache->flight_lock, K_FOREVER);
+		}
+
+		rc = flight->rc;
+		if (!rc && strlen(flight->rsp) >= rsp_size) {
+			rc = -EMSGSIZE;
+		} else if (!rc) {
+			strcpy(rsp, flight->rsp);
+		}
+
+		bool dropped = flight->rsp_dropped;
+
+		flight->refs--;
+
+		k_mutex_unlock(&cache->flight_lock);
+
+		if (dropped) {
+			*shared = false;
+			return prv_request(dev, req, rsp, rsp_size);
+		}
+
+		k_mutex_lock(&cache->lock, K_FOREVER);
+		cache->coalesced++;
+		k_mutex_unlock(&cache->lock);
+
+		*shared = true;
+		return rc;
+	}
+
+	if (free_flight) {
+		free_flight->req = req;
+		free_flight->done = false;
+		free_flight->refs = 1;
+	}
+
+	k_mutex_unlock(&cache->flight_lock);
+
+	*shared = false;
+	rc = prv_request(dev, req, rsp, rsp_size);
+
+	if (!free_flight) {
+		return rc;
+	}
+
+	k_mutex_lock(&cache->flight_lock, K_FOREVER);
+
+	/* Request belongs to the caller, so nobody can join the slot from now on. */
+	free_flight->req = NULL;
+	free_flight->rc = rc;
+	free_flight->rsp_dropped = !rc && strlen(rsp) >= sizeof(free_flight->rsp);
+	if (!rc && !free_flight->rsp_dropped) {
+		strcpy(free_flight->rsp, rsp);
+	}
+	free_flight->done = true;
+	free_flight->refs--;
+	k_condvar_broadcast(&cache->flight_cond);
+
+	k_mutex_unlock(&cache->flight_lock);
+
+	return rc;
+}
+#else
+static int prv_request_coalesced(const struct device *dev, const char *req, char *rsp,
+				 size_t rsp_size, bool *shared)
+{
+	*shared = false;
+
+	return prv_request(dev, req, rsp, rsp_size);
+}
+#endif
+
+void notecard_cache_init(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+
+	k_mutex_init(&data->cache.lock);
+#if CONFIG_NOTECARD_CACHE_COALESCE_SLOTS
+	k_mutex_init(&data->cache.flight_lock);
+	k_condvar_init(&data->cache.flight_cond);
+#endif
+}
+
+int notecard_request_cached(const struct device *dev, const char *req, char *rsp,
+			    size_t rsp_size)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_cache_data *cache = &data->cache;
+
+	/* Thread that sends the same request might be waiting for the control. */
+	__ASSERT(notecard_ctrl_owner() != dev, "Caller must not hold the control of the notecard");
+
+	uint32_t ttl_ms = prv_ttl_get(req);
+	bool cacheable = ttl_ms > 0 && strlen(req) <= CONFIG_NOTECARD_CACHE_REQ_MAX_LEN;
+	int rc = -ENOENT;
+
+	if (cacheable) {
+		k_mutex_lock(&cache->lock, K_FOREVER);
+
+		struct notecard_cache_entry *entry = prv_entry_find(cache, req);
+
+		if (!entry) {
+			cache->misses++;
+		} else if (strlen(entry->rsp) >= rsp_size) {
+			rc = -EMSGSIZE;
+		} else {
+			strcpy(rsp, entry->rsp);
+			cache->hits++;
+			rc = 0;
+		}
+
+		k_mutex_unlock(&cache->lock);
+
+		if (rc != -ENOENT) {
+			return rc;
+		}
+	}
+
+	bool shared;
+
+	rc = prv_request_coalesced(dev, req, rsp, rsp_size, &shared);
+	if (rc || shared || !cacheable || strlen(rsp) > CONFIG_NOTECARD_CACHE_RSP_MAX_LEN ||
+	    strstr(rsp, "\"err\":")) {
+		return rc;
+	}
+
+	k_mutex_lock(&cache->lock, K_FOREVER);
+
+	struct notecard_cache_entry *entry = prv_entry_get(cache, req);
+
+	strcpy(entry->req, req);
+	strcpy(entry->rsp, rsp);
+	entry->expires = sys_timepoint_calc(K_MSEC(ttl_ms));
+
+	k_mutex_unlock(&cache->lock);
+
+	return 0;
+}
+
+void notecard_cache_invalidate(const struct device *dev, const char *name)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_cache_data *cache = &data->cache;
+
+	k_mutex_lock(&cache->lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache->entries); i++) {
+		struct notecard_cache_entry *entry = &cache->entries[i];
+
+		if (!name || prv_name_matches(entry->req, name)) {
+			entry->req[0] = '\0';
+		}
+	}
+
+	k_mutex_unlock(&cache->lock);
+}
+
+void notecard_cache_stats_get(const struct device *dev, struct notecard_cache_stats *stats)
+{
+	struct notecard_data *data = dev->data;
+
+	k_mutex_lock(&data->cache.lock, K_FOREVER);
+	stats->hits = data->cache.hits;
+	stats->misses = data->cache.misses;
+	stats->coalesced = data->cache.coalesced;
+	k_mutex_unlock(&data->cache.lock);
+}
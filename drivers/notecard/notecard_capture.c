@@ -0,0 +1,159 @@
+/** @file notecard_capture.c
+ *
+ * @brief Capture of the raw bytes exchanged with the notecard.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/ring_buffer.h>
+
+BUILD_ASSERT(CONFIG_NOTECARD_CAPTURE_BUF_SIZE >=
+		     2 * (sizeof(struct notecard_capture_hdr) + NOTECARD_CAPTURE_RECORD_MAX_LEN),
+	     "Capture buffer needs to fit at least two records");
+
+/* Received bytes are collected into a single record until the end of the line, since note-c
+ * receives them one at a time. */
+#define CAPTURE_RX_STAGE_LEN 64
+
+static uint8_t prv_ring_buf[CONFIG_NOTECARD_CAPTURE_BUF_SIZE];
+static struct ring_buf prv_ring = RING_BUF_INIT(prv_ring_buf, sizeof(prv_ring_buf));
+
+/* Protects all variables below and the ring buffer. */
+static struct k_spinlock prv_lock;
+static uint32_t prv_dropped;
+static uint8_t prv_rx_stage[CAPTURE_RX_STAGE_LEN];
+static size_t prv_rx_stage_len;
+static uint32_t prv_rx_stage_timestamp;
+
+/**
+ * @brief Drop the oldest record, caller needs to hold the lock.
+ */
+static void prv_record_drop(void)
+{
+	struct notecard_capture_hdr hdr;
+
+	ring_buf_get(&prv_ring, (uint8_t *)&hdr, sizeof(hdr));
+	ring_buf_get(&prv_ring, NULL, hdr.len);
+	prv_dropped++;
+}
+
+/**
+ * @brief Add record, dropping the oldest ones to make space for it. Caller needs to hold the
+ * lock.
+ */
+static void prv_record_put(uint8_t dir, uint32_t timestamp, const uint8_t *buf, size_t len)
+{
+	struct notecard_capture_hdr hdr = {
+		.timestamp_us = timestamp,
+		.len = len,
+		.dir = dir,
+	};
+
+	while (ring_buf_space_get(&prv_ring) < sizeof(hdr) + len) {
+		prv_record_drop();
+	}
+
+	ring_buf_put(&prv_ring, (const uint8_t *)&hdr, sizeof(hdr));
+	ring_buf_put(&prv_ring, buf, len);
+}
+
+/**
+ * @brief Add staged received bytes as a record, caller needs to hold the lock.
+ */
+static void prv_rx_stage_flush(void)
+{
+	if (prv_rx_stage_len == 0) {
+		return;
+	}
+
+	prv_record_put(NOTECARD_CAPTURE_RX, prv_rx_stage_timestamp, prv_rx_stage, prv_rx_stage_len);
+	prv_rx_stage_len = 0;
+}
+
+void notecard_capture_tx(const uint8_t *buf, size_t len)
+{
+	uint32_t timestamp = notecard_capture_timestamp();
+
+	K_SPINLOCK(&prv_lock) {
+		/* Anything received so far precedes this transmission. */
+		prv_rx_stage_flush();
+
+		for (size_t i = 0; i < len; i += NOTECARD_CAPTURE_RECORD_MAX_LEN) {
+			prv_record_put(NOTECARD_CAPTURE_TX, timestamp, &buf[i],
+				       MIN(len - i, NOTECARD_CAPTURE_RECORD_MAX_LEN));
+		}
+	}
+}
+
+void notecard_capture_rx(const uint8_t *buf, size_t len)
+{
+	uint32_t timestamp = notecard_capture_timestamp();
+
+	K_SPINLOCK(&prv_lock) {
+		for (size_t i = 0; i < len; i++) {
+			if (prv_rx_stage_len == 0) {
+				prv_rx_stage_timestamp = timestamp;
+			}
+
+			prv_rx_stage[prv_rx_stage_len++] = buf[i];
+
+			if (buf[i] == '\n' || prv_rx_stage_len == sizeof(prv_rx_stage)) {
+				prv_rx_stage_flush();
+			}
+		}
+	}
+}
+
+size_t notecard_capture_get(uint8_t *buf, size_t size)
+{
+	size_t total = 0;
+
+	K_SPINLOCK(&prv_lock) {
+		prv_rx_stage_flush();
+
+		while (true) {
+			struct notecard_capture_hdr hdr;
+
+			if (ring_buf_peek(&prv_ring, (uint8_t *)&hdr, sizeof(hdr)) != sizeof(hdr)) {
+				break;
+			}
+
+			size_t n = sizeof(hdr) + hdr.len;
+
+			if (n > size - total) {
+				break;
+			}
+
+			ring_buf_get(&prv_ring, &buf[total], n);
+			total += n;
+		}
+	}
+
+	return total;
+}
+
+void notecard_capture_clear(void)
+{
+	K_SPINLOCK(&prv_lock) {
+		ring_buf_reset(&prv_ring);
+		prv_rx_stage_len = 0;
+		prv_dropped = 0;
+	}
+}
+
+uint32_t notecard_capture_dropped(void)
+{
+	uint32_t dropped;
+
+	K_SPINLOCK(&prv_lock) {
+		dropped = prv_dropped;
+	}
+
+	return dropped;
+}
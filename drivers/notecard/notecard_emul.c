@@ -0,0 +1,301 @@
+/** @file notecard_emul.c
+ *
+ * @brief Emulated notecard on the emulated i2c and uart buses.
+ *
+ * Emulator speaks the notecard's chunked i2c framing and line based serial framing and answers a
+ * set of common requests with fixed responses. Only the request name is parsed, so it needs to
+ * be among the first bytes of the request, like it is in requests that note-c and the
+ * notecard_writer_*() API send.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/printk.h>
+
+#if NOTECARD_BUS_I2C
+#include <zephyr/drivers/i2c_emul.h>
+#endif
+#if NOTECARD_BUS_UART
+#include <zephyr/drivers/serial/uart_emul.h>
+#endif
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* Only the start of every request is kept, it holds the request name. */
+#define EMUL_REQ_HEAD_LEN 128
+#define EMUL_RSP_MAX_LEN  512
+
+struct notecard_emul_data {
+	/* Start of the request that is being received. */
+	char req[EMUL_REQ_HEAD_LEN];
+	size_t req_len;
+	/* Request line has content, empty lines are echoed back. */
+	bool req_content;
+
+	/* Last response, i2c host reads it in chunks, uart one is put into the rx fifo at once. */
+	char rsp[EMUL_RSP_MAX_LEN];
+	size_t rsp_len;
+	size_t rsp_pos;
+	/* Number of bytes the host asked for with the last read query (i2c only). */
+	uint8_t read_size;
+};
+
+struct emul_rsp {
+	const char *req;
+	const char *rsp;
+};
+
+static const struct emul_rsp prv_rsps[] = {
+	{"card.version",
+	 "{\"body\":{\"org\":\"Blues Wireless\",\"product\":\"Notecard\",\"version\":"
+	 "\"notecard-emul\",\"ver_major\":7,\"ver_minor\":0,\"ver_patch\":0,\"ver_build\":0},"
+	 "\"version\":\"notecard-emul\",\"device\":\"dev:000000000000000\",\"name\":"
+	 "\"Blues Wireless Notecard\",\"sku\":\"NOTE-EMUL\",\"api\":7}"},
+	{"card.status", "{\"status\":\"{normal}\",\"usb\":true,\"storage\":8,\"connected\":true}"},
+	{"card.temp", "{\"value\":23.5,\"calibration\":-3.0}"},
+	{"card.time", "{\"time\":1767225600,\"zone\":\"UTC,Unknown\"}"},
+	{"card.attn", "{}"},
+	{"hub.get", "{\"mode\":\"periodic\",\"product\":\"com.example:emul\"}"},
+	{"hub.set", "{}"},
+	{"hub.status", "{\"status\":\"connected {connected}\",\"connected\":true}"},
+	{"note.add", "{\"total\":1}"},
+	{"note.template", "{\"bytes\":24}"},
+	{"note.update", "{}"},
+};
+
+/**
+ * @brief Extract name of the request from the start of the request line.
+ *
+ * @return Length of the name, 0 if the request has no name.
+ */
+static size_t prv_req_name(const char *req, size_t len, const char **name, bool *is_cmd)
+{
+	static const char *const keys[] = {"\"req\":\"", "\"cmd\":\""};
+
+	for (size_t i = 0; i < ARRAY_SIZE(keys); i++) {
+		size_t key_len = strlen(keys[i]);
+		const char *start = NULL;
+
+		for (size_t pos = 0; pos + key_len <= len; pos++) {
+			if (memcmp(&req[pos], keys[i], key_len) == 0) {
+				start = &req[pos + key_len];
+				break;
+			}
+		}
+
+		if (!start) {
+			continue;
+		}
+
+		const char *end = memchr(start, '"', len - (start - req));
+		if (!end) {
+			return 0;
+		}
+
+		*name = start;
+		*is_cmd = i == 1;
+
+		return end - start;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Build response to the received request line.
+ *
+ * @return Length of the response without the terminating null, 0 if there is no response (i.e.
+ * request was a command).
+ */
+static size_t prv_respond(struct notecard_emul_data *data, char *rsp, size_t size)
+{
+	if (!data->req_content) {
+		/* Notecard echoes empty lines, this is how its presence is checked. */
+		return snprintk(rsp, size, "\r\n");
+	}
+
+	const char *name;
+	bool is_cmd = false;
+	size_t name_len = prv_req_name(data->req, data->req_len, &name, &is_cmd);
+
+	if (is_cmd) {
+		return 0;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(prv_rsps); i++) {
+		if (strlen(prv_rsps[i].req) == name_len &&
+		    memcmp(prv_rsps[i].req, name, name_len) == 0) {
+			return snprintk(rsp, size, "%s\r\n", prv_rsps[i].rsp);
+		}
+	}
+
+	return snprintk(rsp, size, "{\"err\":\"unknown request: %.*s {not-supported}\"}\r\n",
+			(int)name_len, name_len ? name : "");
+}
+
+/**
+ * @brief Feed bytes that the host transmitted.
+ *
+ * Response to every completed request line replaces the unread one in the response buffer.
+ *
+ * @param[in] on_rsp	Called after a response was put into the response buffer, can be NULL.
+ */
+static void prv_rx(struct notecard_emul_data *data, const uint8_t *buf, size_t len,
+		   void (*on_rsp)(struct notecard_emul_data *data, void *ctx), void *ctx)
+{
+	for (size_t i = 0; i < len; i++) {
+		char c = buf[i];
+
+		if (c != '\n') {
+			if (data->req_len < sizeof(data->req)) {
+				data->req[data->req_len++] = c;
+			}
+			data->req_content = data->req_content || (c != '\r' && c != ' ');
+			continue;
+		}
+
+		size_t rsp_len = prv_respond(data, data->rsp, sizeof(data->rsp));
+
+		data->req_len = 0;
+		data->req_content = false;
+
+		if (rsp_len == 0) {
+			continue;
+		}
+
+		data->rsp_len = MIN(rsp_len, sizeof(data->rsp) - 1);
+		data->rsp_pos = 0;
+
+		if (on_rsp) {
+			on_rsp(data, ctx);
+		}
+	}
+}
+
+static int prv_emul_init(const struct emul *target, const struct device *parent)
+{
+	ARG_UNUSED(parent);
+
+	struct notecard_emul_data *data = target->data;
+
+	memset(data, 0, sizeof(*data));
+
+	return 0;
+}
+
+#if NOTECARD_BUS_I2C
+static int prv_i2c_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+			    int addr)
+{
+	ARG_UNUSED(addr);
+
+	struct notecard_emul_data *data = target->data;
+	bool write_seen = false;
+	/* Length of the payload that follows the length byte of a transmitted chunk. */
+	size_t chunk_left = 0;
+	/* Offset of the next byte of the read, reads continue across messages. */
+	size_t read_pos = 0;
+
+	for (int i = 0; i < num_msgs; i++) {
+		struct i2c_msg *msg = &msgs[i];
+
+		if ((msg->flags & I2C_MSG_RW_MASK) == I2C_MSG_WRITE) {
+			const uint8_t *buf = msg->buf;
+			size_t len = msg->len;
+
+			if (!write_seen && len > 0) {
+				write_seen = true;
+
+				if (buf[0] == 0) {
+					/* Read query: zero length byte followed by the read size. */
+					data->read_size = len > 1 ? buf[1] : 0;
+					continue;
+				}
+
+				chunk_left = buf[0];
+				buf++;
+				len--;
+			}
+
+			len = MIN(len, chunk_left);
+			chunk_left -= len;
+			prv_rx(data, buf, len, NULL, NULL);
+			continue;
+		}
+
+		/* Two header bytes (bytes available after this read and returned bytes), followed by
+		 * the response bytes. */
+		for (uint32_t j = 0; j < msg->len; j++, read_pos++) {
+			size_t pending = data->rsp_len - data->rsp_pos;
+
+			if (read_pos == 0) {
+				msg->buf[j] = MIN(pending - MIN(pending, data->read_size), UINT8_MAX);
+			} else if (read_pos == 1) {
+				msg->buf[j] = data->read_size;
+			} else {
+				msg->buf[j] = pending > 0 ? data->rsp[data->rsp_pos++] : 0;
+			}
+		}
+	}
+
+	return 0;
+}
+
+static const struct i2c_emul_api prv_i2c_api = {
+	.transfer = prv_i2c_transfer,
+};
+#endif /* NOTECARD_BUS_I2C */
+
+#if NOTECARD_BUS_UART
+static void prv_uart_on_rsp(struct notecard_emul_data *data, void *ctx)
+{
+	const struct device *uart = ctx;
+
+	if (uart_emul_put_rx_data(uart, (const uint8_t *)data->rsp, data->rsp_len) !=
+	    data->rsp_len) {
+		LOG_WRN("Emulated uart rx fifo is too small for the response");
+	}
+
+	data->rsp_pos = data->rsp_len;
+}
+
+static void prv_uart_tx_data_ready(const struct device *dev, size_t size, const struct emul *target)
+{
+	struct notecard_emul_data *data = target->data;
+	uint8_t buf[32];
+
+	while (size > 0) {
+		uint32_t n = uart_emul_get_tx_data(dev, buf, MIN(size, sizeof(buf)));
+
+		if (n == 0) {
+			break;
+		}
+
+		prv_rx(data, buf, n, prv_uart_on_rsp, (void *)dev);
+		size -= n;
+	}
+}
+
+static const struct uart_emul_device_api prv_uart_api = {
+	.tx_data_ready = prv_uart_tx_data_ready,
+};
+#endif /* NOTECARD_BUS_UART */
+
+#define NOTECARD_EMUL_BUS_API(inst)                                                                \
+	COND_CODE_1(DT_INST_ON_BUS(inst, uart), (&prv_uart_api), (&prv_i2c_api))
+
+#define NOTECARD_EMUL_DEFINE(inst)                                                                 \
+	static struct notecard_emul_data notecard_emul_data_##inst;                                \
+                                                                                                   \
+	EMUL_DT_INST_DEFINE(inst, prv_emul_init, &notecard_emul_data_##inst, NULL,                 \
+			    NOTECARD_EMUL_BUS_API(inst), NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(NOTECARD_EMUL_DEFINE)
@@ -13,42 +13,159 @@
 
 #include <zephyr/drivers/i2c.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/logging/log_ctrl.h>
 #include <zephyr/sys/__assert.h>
 
 #include <note.h>
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
+/* Local pointer to the i2c device that is currently used for communication */
 static const struct device *prv_i2c_dev;
 
-LOG_MODULE_DECLARE(note);
+/* Local pointer to the data of the i2c bus that is currently used for communication */
+static struct notecard_i2c_data *prv_i2c_data;
 
-static const char *prv_receive(uint16_t device_address, uint8_t *buffer, uint16_t size,
-			       uint32_t *available)
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/**
+ * @brief Check if the i2c controller rejected scatter/gather messages and remember it.
+ *
+ * nRF TWIM merges consecutive messages in its concatenation buffer and fails with -ENOSPC
+ * when zephyr,concat-buf-size is too small for them. Nothing is sent on the bus in that case,
+ * so the transfer can be repeated with a single buffer.
+ *
+ * @return true if the transfer needs to be repeated with a single buffer.
+ */
+static bool prv_sg_rejected(struct notecard_i2c_data *data, int rc)
+{
+	if (rc != -ENOSPC) {
+		return false;
+	}
+
+	LOG_WRN("i2c controller rejected scatter/gather transfer, using a single buffer, set "
+		"zephyr,concat-buf-size to at least 258 to avoid it");
+	data->single_buf = true;
+
+	return true;
+}
+
+/**
+ * @brief Read the header and the chunk as a single buffer, staged on stack.
+ */
+static __noinline int prv_read_single(const struct device *i2c_dev, uint16_t device_address,
+				      uint8_t header[2], uint8_t *buffer, uint16_t size)
+{
+	uint8_t staging[2 + NOTE_I2C_MAX_MAX];
+
+	int rc = i2c_read(i2c_dev, staging, 2 + size, device_address);
+	if (rc) {
+		return rc;
+	}
+
+	memcpy(header, staging, 2);
+	if (size > 0) {
+		memcpy(buffer, staging + 2, size);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write the header and the chunk as a single buffer, staged on stack.
+ */
+static __noinline int prv_write_single(const struct device *i2c_dev, uint16_t device_address,
+				       uint8_t header, const uint8_t *buffer, uint16_t size)
+{
+	uint8_t staging[1 + NOTE_I2C_MAX_MAX];
+
+	staging[0] = header;
+	memcpy(staging + 1, buffer, size);
+
+	return i2c_write(i2c_dev, staging, 1 + size, device_address);
+}
+
+/**
+ * @brief Receive a single chunk from the notecard.
+ *
+ * @param[out] buffer	Buffer for the chunk, can be NULL if size is 0.
+ * @param[in] size	Number of bytes to receive, 0 only queries the number of available bytes.
+ * @param[out] available Number of bytes that are still available on the notecard.
+ *
+ * @return 0 on success, negative error code otherwise.
+ */
+static int prv_read_chunk(const struct device *i2c_dev, uint16_t device_address,
+			  struct notecard_i2c_data *data, uint8_t *buffer, uint16_t size,
+			  uint32_t *available)
 {
 	/* Let the Notecard know that we are getting ready to read some data */
 	uint8_t sizebuf[2] = {0, (uint8_t)size};
 
-	if (i2c_write(prv_i2c_dev, sizebuf, sizeof(sizebuf), device_address) != 0) {
-		return "i2c: Unable to initiate read from the Notecard\n";
+	int rc = i2c_write(i2c_dev, sizebuf, sizeof(sizebuf), device_address);
+	if (rc) {
+		return rc;
+	}
+
+	/* Notecard responds with two header bytes (available bytes and returned bytes), followed by
+	 * the response bytes. */
+	uint8_t header[2];
+	bool single = size == 0 || data->single_buf;
+
+	if (!single) {
+		/* Response bytes are read directly into the response buffer. */
+		struct i2c_msg msgs[2] = {
+			{
+				.buf = header,
+				.len = sizeof(header),
+				.flags = I2C_MSG_READ,
+			},
+			{
+				.buf = buffer,
+				.len = size,
+				.flags = I2C_MSG_READ | I2C_MSG_STOP,
+			},
+		};
+
+		rc = i2c_transfer(i2c_dev, msgs, ARRAY_SIZE(msgs), device_address);
+		single = prv_sg_rejected(data, rc);
+	}
+
+	if (single) {
+		rc = prv_read_single(i2c_dev, device_address, header, buffer, size);
+	}
+
+	if (rc) {
+		return rc;
+	}
+
+	if (header[1] != size) {
+		return -EPROTO;
 	}
 
-	/* Read from the Notecard and copy the response bytes into the response buffer */
-	uint8_t read_buf[256];
+	*available = (uint32_t)header[0];
+
+	return 0;
+}
+
+static const char *prv_receive(uint16_t device_address, uint8_t *buffer, uint16_t size,
+			       uint32_t *available)
+{
+	int rc = prv_read_chunk(prv_i2c_dev, device_address, prv_i2c_data, buffer, size,
+				available);
 
-	/* We add 2 to the size due to the request header. */
-	if (i2c_read(prv_i2c_dev, read_buf, size + 2, device_address) != 0) {
-		return "i2c: Unable to receive data from the Notecard.\n";
+	notecard_stats_rx(notecard_ctrl_owner(), size, rc == 0 && size > 0 && buffer[size - 1] == '\n',
+			  rc);
+	if (rc == 0) {
+		notecard_capture_rx(buffer, size);
 	}
 
-	*available = (uint32_t)read_buf[0];
-	uint8_t bytes_to_read = read_buf[1];
-	for (size_t i = 0; i < bytes_to_read; i++) {
-		buffer[i] = read_buf[i + 2];
+	if (rc == -EPROTO) {
+		return "i2c: Unexpected protocol byte count from the Notecard.\n";
 	}
 
-	return NULL;
+	return rc ? "i2c: Unable to receive data from the Notecard.\n" : NULL;
 }
 
 static bool prv_reset(uint16_t device_address)
@@ -59,26 +176,188 @@ static bool prv_reset(uint16_t device_address)
 	return true;
 }
 
-static const char *prv_transmit(uint16_t device_address, uint8_t *buffer, uint16_t size)
+/**
+ * @brief Transmit a single chunk to the notecard.
+ *
+ * Length header and the payload are sent as a single write, payload directly from the given
+ * buffer, unless the i2c controller can only transfer a single buffer.
+ *
+ * @return 0 on success, negative error code otherwise.
+ */
+static int prv_write_chunk(const struct device *i2c_dev, uint16_t device_address,
+			   struct notecard_i2c_data *data, const uint8_t *buffer, uint16_t size)
 {
 	__ASSERT(size < 256, "i2c transmit size needs to be less than 256");
 
-	uint8_t write_buf[256];
+	uint8_t header = (uint8_t)size;
+
+	if (!data->single_buf) {
+		struct i2c_msg msgs[2] = {
+			{
+				.buf = &header,
+				.len = sizeof(header),
+				.flags = I2C_MSG_WRITE,
+			},
+			{
+				.buf = (uint8_t *)buffer,
+				.len = size,
+				.flags = I2C_MSG_WRITE | I2C_MSG_STOP,
+			},
+		};
+
+		int rc = i2c_transfer(i2c_dev, msgs, ARRAY_SIZE(msgs), device_address);
+		if (!prv_sg_rejected(data, rc)) {
+			return rc;
+		}
+	}
+
+	return prv_write_single(i2c_dev, device_address, header, buffer, size);
+}
+
+static const char *prv_transmit(uint16_t device_address, uint8_t *buffer, uint16_t size)
+{
+	uint32_t start = notecard_stats_now();
+	int rc = prv_write_chunk(prv_i2c_dev, device_address, prv_i2c_data, buffer, size);
+
+	notecard_stats_tx(notecard_ctrl_owner(), size, start, rc);
+	if (rc == 0) {
+		notecard_capture_tx(buffer, size);
+	}
+
+	return rc == 0 ? NULL : "i2c: Unable to transmit data to the Notecard\n";
+}
 
-	write_buf[0] = (uint8_t)size;
+int notecard_i2c_init(const struct notecard_bus *bus)
+{
+	if (!i2c_is_ready_dt(&bus->dev.i2c)) {
+		LOG_ERR("i2c bus is not ready");
+		return -ENODEV;
+	}
+
+	return 0;
+}
 
-	for (size_t i = 0; i < size; i++) {
-		write_buf[i + 1] = buffer[i];
+#if CONFIG_LOG_RUNTIME_FILTERING
+/* Log source of the nrfx i2c driver while it is silenced, negative otherwise. Protected by the
+ * control of the notecard. */
+static int16_t prv_bus_log_source = -1;
+/* Level of the driver's log filter before it was silenced. */
+static uint32_t prv_bus_log_level;
+#endif
+
+/**
+ * @brief Silence the nrfx i2c driver, which logs an error on every transfer that is not
+ * acknowledged, as it always happens when the notecard is absent.
+ *
+ * Driver stays silenced until the notecard responds again, so repeated checks of an absent
+ * notecard do not touch the log filters.
+ */
+static void prv_bus_log_mute(void)
+{
+#if CONFIG_LOG_RUNTIME_FILTERING
+	if (prv_bus_log_source >= 0) {
+		return;
+	}
+
+	/* Since we do not know whether twi or twim is used, we check both. */
+	int16_t source_id = (int16_t)log_source_id_get("i2c_nrfx_twi");
+	if (source_id < 0) {
+		source_id = (int16_t)log_source_id_get("i2c_nrfx_twim");
+	}
+	if (source_id < 0) {
+		return;
+	}
+
+	prv_bus_log_level = log_filter_get(NULL, 0, source_id, true);
+	log_filter_set(NULL, 0, source_id, LOG_LEVEL_NONE);
+	prv_bus_log_source = source_id;
+#endif
+}
+
+/**
+ * @brief Restore the log filter of the i2c driver, if it was silenced.
+ */
+static void prv_bus_log_unmute(void)
+{
+#if CONFIG_LOG_RUNTIME_FILTERING
+	if (prv_bus_log_source < 0) {
+		return;
 	}
 
-	return i2c_write(prv_i2c_dev, write_buf, size + 1, device_address) == 0
-		       ? NULL
-		       : "i2c: Unable to transmit data to the Notecard\n";
+	log_filter_set(NULL, 0, prv_bus_log_source, prv_bus_log_level);
+	prv_bus_log_source = -1;
+#endif
+}
+
+bool notecard_i2c_is_present(const struct notecard_bus *bus, k_timeout_t timeout)
+{
+	const struct i2c_dt_spec *i2c = &bus->dev.i2c;
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	uint32_t available;
+	bool present;
+
+	/* Ask how many bytes are available, only a present notecard responds with a valid
+	 * header. Notecard does not acknowledge its address while it is still booting, so the
+	 * query is repeated until the timeout. */
+	while (true) {
+		present = prv_read_chunk(i2c->bus, i2c->addr, bus->data, NULL, 0, &available) == 0;
+		if (present || sys_timepoint_expired(end)) {
+			break;
+		}
+
+		/* First error of the driver is logged, the rest are the same. */
+		prv_bus_log_mute();
+		k_msleep(NOTECARD_PROBE_RETRY_MS);
+	}
+
+	if (present) {
+		prv_bus_log_unmute();
+	}
+
+	return present;
+}
+
+int notecard_i2c_write(const struct notecard_bus *bus, const uint8_t *buf, size_t len)
+{
+	__ASSERT(len <= NOTE_I2C_MAX_MAX, "Chunk does not fit into a single i2c transmission");
+
+	const struct i2c_dt_spec *i2c = &bus->dev.i2c;
+
+	int rc = prv_write_chunk(i2c->bus, i2c->addr, bus->data, buf, len);
+	if (rc) {
+		LOG_ERR("Failed to transmit chunk (err=%d)", rc);
+	}
+
+	return rc;
+}
+
+int notecard_i2c_read(const struct notecard_bus *bus, uint8_t *buf, size_t size)
+{
+	const struct i2c_dt_spec *i2c = &bus->dev.i2c;
+	uint32_t available;
+
+	int rc = prv_read_chunk(i2c->bus, i2c->addr, bus->data, NULL, 0, &available);
+	if (rc) {
+		return rc;
+	}
+
+	/* Notecard responds again without a presence check in between. */
+	prv_bus_log_unmute();
+
+	uint16_t chunk_len = MIN(MIN(size, available), NOTE_I2C_MAX_MAX);
+	if (chunk_len == 0) {
+		return 0;
+	}
+
+	rc = prv_read_chunk(i2c->bus, i2c->addr, bus->data, buf, chunk_len, &available);
+
+	return rc ? rc : chunk_len;
 }
 
 void notecard_i2c_attach_bus_api(const struct notecard_bus *bus)
 {
 	prv_i2c_dev = bus->dev.i2c.bus;
+	prv_i2c_data = bus->data;
 
 	/* Give note-c uart hooks.
 	 * Second argument tells note-c how large chunks can be send over i2c. */
@@ -0,0 +1,503 @@
+/** @file notecard_json.c
+ *
+ * @brief Streaming response parser, which reports fields while the response is being received.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/__assert.h>
+
+#include <note.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* Maximum nesting of objects and arrays, limited by the is_object bitmask. */
+#define JSON_MAX_DEPTH 31
+
+enum json_state {
+	/* Expecting a value. */
+	JSON_STATE_VALUE,
+	/* After '{', expecting a key or '}'. */
+	JSON_STATE_KEY_OR_END,
+	/* After '[', expecting a value or ']'. */
+	JSON_STATE_VALUE_OR_END,
+	/* After ',' in an object, expecting a key. */
+	JSON_STATE_KEY,
+	/* After a key, expecting ':'. */
+	JSON_STATE_COLON,
+	/* Inside of a string, key or value. */
+	JSON_STATE_STRING,
+	/* After '\' inside of a string. */
+	JSON_STATE_STRING_ESC,
+	/* Inside of a "\uXXXX" escape sequence. */
+	JSON_STATE_STRING_UNICODE,
+	/* Inside of a number, true, false or null. */
+	JSON_STATE_LITERAL,
+	/* After a value inside of an object or array, expecting ',' or end of it. */
+	JSON_STATE_COMMA_OR_END,
+	/* Top level value was parsed. */
+	JSON_STATE_DONE,
+	/* Response is malformed, rest of it is ignored. */
+	JSON_STATE_ERROR,
+};
+
+static void prv_emit(struct notecard_json_parser *p, enum notecard_json_type type, bool more)
+{
+	if (p->cb_err) {
+		/* Callback asked to stop, rest of the response is only parsed to find its end. */
+		return;
+	}
+
+	struct notecard_json_field field = {
+		.key = p->has_key ? p->key : NULL,
+		.depth = p->depth,
+		.type = type,
+		.value = p->value,
+		.value_len = p->value_len,
+		.more = more,
+	};
+
+	p->value[p->value_len] = '\0';
+	p->cb_err = p->cb(&field, p->user_data);
+}
+
+static void prv_value_end(struct notecard_json_parser *p)
+{
+	p->has_key = false;
+	p->value_len = 0;
+	p->state = p->depth == 0 ? JSON_STATE_DONE : JSON_STATE_COMMA_OR_END;
+}
+
+static void prv_push(struct notecard_json_parser *p, bool is_object)
+{
+	if (p->depth == JSON_MAX_DEPTH) {
+		p->state = JSON_STATE_ERROR;
+		return;
+	}
+
+	prv_emit(p, is_object ? NOTECARD_JSON_OBJECT_BEGIN : NOTECARD_JSON_ARRAY_BEGIN, false);
+
+	p->depth++;
+	WRITE_BIT(p->is_object, p->depth, is_object);
+	p->has_key = false;
+	p->state = is_object ? JSON_STATE_KEY_OR_END : JSON_STATE_VALUE_OR_END;
+}
+
+static void prv_pop(struct notecard_json_parser *p, bool is_object)
+{
+	if (p->depth == 0 || !!(p->is_object & BIT(p->depth)) != is_object) {
+		p->state = JSON_STATE_ERROR;
+		return;
+	}
+
+	p->depth--;
+	p->has_key = false;
+	prv_emit(p, is_object ? NOTECARD_JSON_OBJECT_END : NOTECARD_JSON_ARRAY_END, false);
+	prv_value_end(p);
+}
+
+/**
+ * @brief Append a character to the key or string value that is being parsed.
+ *
+ * Keys that are too long are truncated, string values that are too long are reported in
+ * several pieces.
+ */
+static void prv_string_put(struct notecard_json_parser *p, char c)
+{
+	if (p->in_key) {
+		if (p->key_len < CONFIG_NOTECARD_JSON_KEY_MAX_LEN) {
+			p->key[p->key_len++] = c;
+		}
+		return;
+	}
+
+	if (p->value_len == CONFIG_NOTECARD_JSON_VALUE_MAX_LEN) {
+		prv_emit(p, NOTECARD_JSON_STRING, true);
+		p->value_len = 0;
+	}
+
+	p->value[p->value_len++] = c;
+}
+
+static void prv_string_begin(struct notecard_json_parser *p, bool is_key)
+{
+	if (is_key) {
+		p->key_len = 0;
+	}
+	p->in_key = is_key;
+	p->value_len = 0;
+	p->state = JSON_STATE_STRING;
+}
+
+static void prv_string_end(struct notecard_json_parser *p)
+{
+	if (p->in_key) {
+		p->key[p->key_len] = '\0';
+		p->in_key = false;
+		p->has_key = true;
+		p->state = JSON_STATE_COLON;
+		return;
+	}
+
+	prv_emit(p, NOTECARD_JSON_STRING, false);
+	prv_value_end(p);
+}
+
+/* Replacement character, for surrogates that are not part of a pair. */
+#define JSON_UNICODE_REPLACEMENT 0xFFFD
+
+/**
+ * @brief Append code point, encoded as UTF-8.
+ */
+static void prv_string_put_unicode(struct notecard_json_parser *p, uint32_t cp)
+{
+	if (cp < 0x80) {
+		prv_string_put(p, cp);
+	} else if (cp < 0x800) {
+		prv_string_put(p, 0xC0 | (cp >> 6));
+		prv_string_put(p, 0x80 | (cp & 0x3F));
+	} else if (cp < 0x10000) {
+		prv_string_put(p, 0xE0 | (cp >> 12));
+		prv_string_put(p, 0x80 | ((cp >> 6) & 0x3F));
+		prv_string_put(p, 0x80 | (cp & 0x3F));
+	} else {
+		prv_string_put(p, 0xF0 | (cp >> 18));
+		prv_string_put(p, 0x80 | ((cp >> 12) & 0x3F));
+		prv_string_put(p, 0x80 | ((cp >> 6) & 0x3F));
+		prv_string_put(p, 0x80 | (cp & 0x3F));
+	}
+}
+
+/**
+ * @brief Replace high surrogate, which was not followed by a low one.
+ */
+static void prv_surrogate_flush(struct notecard_json_parser *p)
+{
+	if (p->high_surrogate) {
+		p->high_surrogate = 0;
+		prv_string_put_unicode(p, JSON_UNICODE_REPLACEMENT);
+	}
+}
+
+/**
+ * @brief Append code unit of a "\uXXXX" escape sequence.
+ *
+ * Code points outside of the basic plane are escaped as a pair of surrogates, high one is kept
+ * until the low one arrives.
+ */
+static void prv_string_put_escaped(struct notecard_json_parser *p, uint16_t unit)
+{
+	if (unit >= 0xD800 && unit <= 0xDBFF) {
+		prv_surrogate_flush(p);
+		p->high_surrogate = unit;
+		return;
+	}
+
+	if (unit >= 0xDC00 && unit <= 0xDFFF) {
+		uint32_t cp = JSON_UNICODE_REPLACEMENT;
+
+		if (p->high_surrogate) {
+			cp = 0x10000 + (((uint32_t)p->high_surrogate - 0xD800) << 10) +
+			     (unit - 0xDC00);
+			p->high_surrogate = 0;
+		}
+
+		prv_string_put_unicode(p, cp);
+		return;
+	}
+
+	prv_surrogate_flush(p);
+	prv_string_put_unicode(p, unit);
+}
+
+static void prv_literal_end(struct notecard_json_parser *p)
+{
+	enum notecard_json_type type;
+
+	p->value[p->value_len] = '\0';
+
+	if (strcmp(p->value, "true") == 0 || strcmp(p->value, "false") == 0) {
+		type = NOTECARD_JSON_BOOL;
+	} else if (strcmp(p->value, "null") == 0) {
+		type = NOTECARD_JSON_NULL;
+	} else if (p->value[0] == '-' || (p->value[0] >= '0' && p->value[0] <= '9')) {
+		type = NOTECARD_JSON_NUMBER;
+	} else {
+		p->state = JSON_STATE_ERROR;
+		return;
+	}
+
+	prv_emit(p, type, false);
+	prv_value_end(p);
+}
+
+static bool prv_is_space(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static bool prv_is_literal(char c)
+{
+	return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' ||
+	       c == '.' || c == 'E';
+}
+
+static void prv_value(struct notecard_json_parser *p, char c)
+{
+	switch (c) {
+	case '{':
+		prv_push(p, true);
+		break;
+	case '[':
+		prv_push(p, false);
+		break;
+	case '"':
+		prv_string_begin(p, false);
+		break;
+	default:
+		if (!prv_is_literal(c)) {
+			p->state = JSON_STATE_ERROR;
+			break;
+		}
+		p->value_len = 0;
+		p->value[p->value_len++] = c;
+		p->state = JSON_STATE_LITERAL;
+		break;
+	}
+}
+
+static void prv_feed_char(struct notecard_json_parser *p, char c)
+{
+	switch (p->state) {
+	case JSON_STATE_STRING:
+		if (c == '\\') {
+			p->state = JSON_STATE_STRING_ESC;
+			return;
+		}
+
+		prv_surrogate_flush(p);
+
+		if (c == '"') {
+			prv_string_end(p);
+		} else {
+			prv_string_put(p, c);
+		}
+		return;
+	case JSON_STATE_STRING_ESC: {
+		static const char escaped[] = "\"\\/bfnrt";
+		static const char unescaped[] = "\"\\/\b\f\n\r\t";
+		const char *pos = c ? strchr(escaped, c) : NULL;
+
+		p->state = JSON_STATE_STRING;
+
+		if (pos) {
+			prv_surrogate_flush(p);
+			prv_string_put(p, unescaped[pos - escaped]);
+		} else if (c == 'u') {
+			p->unicode = 0;
+			p->unicode_len = 0;
+			p->state = JSON_STATE_STRING_UNICODE;
+		} else {
+			p->state = JSON_STATE_ERROR;
+		}
+		return;
+	}
+	case JSON_STATE_STRING_UNICODE: {
+		uint8_t nibble;
+
+		if (c >= '0' && c <= '9') {
+			nibble = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			nibble = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			nibble = c - 'A' + 10;
+		} else {
+			p->state = JSON_STATE_ERROR;
+			return;
+		}
+
+		p->unicode = (p->unicode << 4) | nibble;
+
+		if (++p->unicode_len == 4) {
+			prv_string_put_escaped(p, p->unicode);
+			p->state = JSON_STATE_STRING;
+		}
+		return;
+	}
+	case JSON_STATE_LITERAL:
+		if (prv_is_literal(c)) {
+			if (p->value_len == CONFIG_NOTECARD_JSON_VALUE_MAX_LEN) {
+				p->state = JSON_STATE_ERROR;
+				return;
+			}
+			p->value[p->value_len++] = c;
+			return;
+		}
+
+		prv_literal_end(p);
+		if (p->state == JSON_STATE_ERROR) {
+			return;
+		}
+		/* Character after the literal still needs to be parsed. */
+		break;
+	case JSON_STATE_ERROR:
+		return;
+	default:
+		break;
+	}
+
+	if (prv_is_space(c)) {
+		return;
+	}
+
+	switch (p->state) {
+	case JSON_STATE_VALUE:
+		prv_value(p, c);
+		break;
+	case JSON_STATE_VALUE_OR_END:
+		if (c == ']') {
+			prv_pop(p, false);
+		} else {
+			prv_value(p, c);
+		}
+		break;
+	case JSON_STATE_KEY_OR_END:
+		if (c == '}') {
+			prv_pop(p, true);
+			break;
+		}
+		__fallthrough;
+	case JSON_STATE_KEY:
+		if (c == '"') {
+			prv_string_begin(p, true);
+		} else {
+			p->state = JSON_STATE_ERROR;
+		}
+		break;
+	case JSON_STATE_COLON:
+		p->state = c == ':' ? JSON_STATE_VALUE : JSON_STATE_ERROR;
+		break;
+	case JSON_STATE_COMMA_OR_END: {
+		bool is_object = p->is_object & BIT(p->depth);
+
+		if (c == ',') {
+			p->state = is_object ? JSON_STATE_KEY : JSON_STATE_VALUE;
+		} else if (c == (is_object ? '}' : ']')) {
+			prv_pop(p, is_object);
+		} else {
+			p->state = JSON_STATE_ERROR;
+		}
+		break;
+	}
+	default:
+		/* Anything after the top level value is ignored. */
+		break;
+	}
+}
+
+void notecard_json_parser_init(struct notecard_json_parser *p, notecard_json_cb_t cb,
+			       void *user_data)
+{
+	__ASSERT(cb, "Callback needs to be provided");
+
+	memset(p, 0, sizeof(*p));
+	p->cb = cb;
+	p->user_data = user_data;
+	p->state = JSON_STATE_VALUE;
+}
+
+void notecard_json_parser_feed(struct notecard_json_parser *p, const char *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		prv_feed_char(p, buf[i]);
+	}
+}
+
+int notecard_json_parser_finish(struct notecard_json_parser *p)
+{
+	if (p->state == JSON_STATE_LITERAL) {
+		prv_literal_end(p);
+	}
+
+	if (p->state != JSON_STATE_DONE) {
+		return -EBADMSG;
+	}
+
+	return p->cb_err;
+}
+
+int notecard_transport_read_parse(struct notecard_transport *tp, struct notecard_json_parser *p,
+				  k_timeout_t timeout)
+{
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	/* Time spent in the parser, without the time spent waiting for the response. */
+	uint32_t parse_cycles = 0;
+
+	/* Response is parsed in small pieces as it arrives, it is never held in memory as a
+	 * whole. */
+	while (true) {
+		char chunk[32];
+
+		int rc = notecard_transport_read(tp, (uint8_t *)chunk, sizeof(chunk));
+		if (rc < 0) {
+			return rc;
+		}
+
+		char *newline = memchr(chunk, '\n', rc);
+		uint32_t start = notecard_stats_now();
+
+		notecard_json_parser_feed(p, chunk, newline ? (size_t)(newline - chunk) : (size_t)rc);
+		parse_cycles += notecard_stats_now() - start;
+
+		if (newline) {
+			break;
+		}
+
+		if (rc == 0) {
+			if (sys_timepoint_expired(end)) {
+				return -ETIMEDOUT;
+			}
+			k_msleep(NOTECARD_RX_POLL_MS);
+		}
+	}
+
+	int rc = notecard_json_parser_finish(p);
+	if (rc == -EBADMSG) {
+		LOG_ERR("Malformed response");
+	}
+
+	/* Start is shifted back by the time spent in the parser, so only that time is recorded. */
+	notecard_stats_latency(tp->dev, NOTECARD_STATS_PARSE, notecard_stats_now() - parse_cycles);
+
+	return rc;
+}
+
+int notecard_request_parse(const struct device *dev, J *req, notecard_json_cb_t cb,
+			   void *user_data)
+{
+	__ASSERT(req, "Request needs to be provided");
+
+	struct notecard_transport tp;
+
+	notecard_transport_init(&tp, dev);
+
+	int rc = notecard_transport_write_json(&tp, req);
+	if (rc) {
+		return rc;
+	}
+
+	struct notecard_json_parser p;
+
+	notecard_json_parser_init(&p, cb, user_data);
+
+	return notecard_transport_read_parse(&tp, &p, K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+}
@@ -0,0 +1,143 @@
+/** @file notecard_log.c
+ *
+ * @brief Bridge between note-c debug output and Zephyr logging.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* note-c outputs the level prefix (for example "[ERROR]") and the message itself with separate
+ * calls. Level of the prefix is kept until the same thread outputs the message. */
+static struct k_spinlock prv_lock;
+static k_tid_t prv_pending_thread;
+static uint8_t prv_pending_level = LOG_LEVEL_NONE;
+
+/**
+ * @brief Parse level prefix of the message.
+ *
+ * @param[in,out] message	Message, moved past the prefix, if it has one.
+ *
+ * @return Log level of the prefix or LOG_LEVEL_NONE, if message has no prefix.
+ */
+static uint8_t prv_level_parse(const char **message)
+{
+	const char *msg = *message;
+	const char *prefix;
+	uint8_t level;
+
+	if (msg[0] != '[') {
+		return LOG_LEVEL_NONE;
+	}
+
+	/* Second character is enough to tell the prefixes apart. */
+	switch (msg[1]) {
+	case 'E':
+		prefix = "[ERROR]";
+		level = LOG_LEVEL_ERR;
+		break;
+	case 'W':
+		prefix = "[WARN]";
+		level = LOG_LEVEL_WRN;
+		break;
+	case 'I':
+		prefix = "[INFO]";
+		level = LOG_LEVEL_INF;
+		break;
+	case 'D':
+		prefix = "[DEBUG]";
+		level = LOG_LEVEL_DBG;
+		break;
+	default:
+		return LOG_LEVEL_NONE;
+	}
+
+	size_t prefix_len = strlen(prefix);
+
+	if (strncmp(msg, prefix, prefix_len) != 0) {
+		return LOG_LEVEL_NONE;
+	}
+
+	msg += prefix_len;
+	while (*msg == ' ') {
+		msg++;
+	}
+
+	*message = msg;
+
+	return level;
+}
+
+/**
+ * @brief Log a single line of the message with the given level.
+ */
+static void prv_log_line(uint8_t level, const char *line, size_t len)
+{
+	/* Line is printed straight from the note-c buffer, precision limits it to the current
+	 * line, so it is neither copied nor truncated. Level needs to be known at compile time for
+	 * the LOG_* macros, hence the switch. */
+	switch (level) {
+	case LOG_LEVEL_ERR:
+		LOG_ERR("%.*s", (int)len, line);
+		break;
+	case LOG_LEVEL_WRN:
+		LOG_WRN("%.*s", (int)len, line);
+		break;
+	case LOG_LEVEL_INF:
+		LOG_INF("%.*s", (int)len, line);
+		break;
+	case LOG_LEVEL_DBG:
+	default:
+		LOG_DBG("%.*s", (int)len, line);
+		break;
+	}
+}
+
+size_t notecard_log_print(const char *message)
+{
+	uint8_t level = prv_level_parse(&message);
+
+	/* Line endings are dropped, logging adds its own. */
+	message += strspn(message, "\r\n");
+
+	if (*message == '\0') {
+		if (level != LOG_LEVEL_NONE) {
+			K_SPINLOCK(&prv_lock) {
+				prv_pending_thread = k_current_get();
+				prv_pending_level = level;
+			}
+		}
+		return 0;
+	}
+
+	if (level == LOG_LEVEL_NONE) {
+		K_SPINLOCK(&prv_lock) {
+			if (prv_pending_thread == k_current_get()) {
+				level = prv_pending_level;
+				prv_pending_level = LOG_LEVEL_NONE;
+				prv_pending_thread = NULL;
+			}
+		}
+	}
+
+	/* Message can span several lines (e.g. a request that is being sent), every one of them is
+	 * logged separately. */
+	while (*message != '\0') {
+		size_t len = strcspn(message, "\r\n");
+
+		prv_log_line(level, message, len);
+
+		message += len;
+		message += strspn(message, "\r\n");
+	}
+
+	return 0;
+}
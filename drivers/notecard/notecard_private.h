@@ -18,11 +18,30 @@ extern "C" {
 
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/drivers/i2c.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/ring_buffer.h>
+
+#if CONFIG_NOTECARD_QUEUE
+#include <zephyr/fs/fcb.h>
+#include <zephyr/storage/flash_map.h>
+#endif
 
 #define DT_DRV_COMPAT     blues_notecard
 #define NOTECARD_BUS_UART DT_ANY_INST_ON_BUS_STATUS_OKAY(uart)
 #define NOTECARD_BUS_I2C  DT_ANY_INST_ON_BUS_STATUS_OKAY(i2c)
 
+/* Pacing of the driver's own transmissions, mirrors what note-c does when it sends a request, so
+ * that the notecard's receive buffers are not overwhelmed. */
+#define NOTECARD_SEGMENT_MAX_LEN    250
+#define NOTECARD_SEGMENT_DELAY_MS   250
+#define NOTECARD_I2C_CHUNK_DELAY_MS 20
+
+/* Pause between presence checks while waiting for the notecard to become ready. */
+#define NOTECARD_PROBE_RETRY_MS 10
+
+/* How often the driver polls for response bytes, when it reads the response itself. */
+#define NOTECARD_RX_POLL_MS 5
+
 union notecard_bus_device {
 #if NOTECARD_BUS_UART
 	const struct device *uart;
@@ -34,21 +53,123 @@ union notecard_bus_device {
 
 struct notecard_bus {
 	union notecard_bus_device dev;
+	/* Bus specific, mutable data of the instance, NULL if bus does not need it. */
+	void *data;
+	int (*init)(const struct notecard_bus *bus);
 	void (*attach_bus_api)(const struct notecard_bus *bus);
+	/* Check if notecard responds, waiting for the response up to the given timeout. */
+	bool (*is_present)(const struct notecard_bus *bus, k_timeout_t timeout);
+	/* Transmit a single chunk of raw bytes to the notecard, bypassing note-c. */
+	int (*write)(const struct notecard_bus *bus, const uint8_t *buf, size_t len);
+	/* Maximum length of a chunk given to write and pause that the notecard needs after every
+	 * chunk, before it can receive the next one. */
+	uint16_t chunk_max_len;
+	uint16_t chunk_delay_ms;
+	/* Receive raw bytes from the notecard, bypassing note-c. Does not block, returns number of
+	 * received bytes (0 if nothing is available) or negative error code. */
+	int (*read)(const struct notecard_bus *bus, uint8_t *buf, size_t size);
+#if CONFIG_NOTECARD_RX_WAKE
+	/* Sleep until the timeout expires. While a response is awaited, sleep ends as soon as
+	 * something is received. NULL if bus can not tell when something is received. */
+	void (*rx_wait)(const struct notecard_bus *bus, k_timeout_t timeout);
+#endif
 };
 
 #if NOTECARD_BUS_UART
+struct notecard_uart_data;
+
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+struct notecard_uart_data {
+	/* Ring buffer, continuously filled by the uart isr. */
+	struct ring_buf rx_ring;
+	uint8_t rx_ring_buf[CONFIG_NOTECARD_UART_RX_BUF_SIZE];
+
+	/* Number of bytes that the isr received. */
+	uint32_t rx_received;
+	/* Number of received bytes that were dropped, because the ring buffer was full. */
+	uint32_t rx_dropped;
+	/* Number of overrun errors reported by the uart driver. */
+	uint32_t rx_hw_overruns;
+
+	/* Protects the transmit buffer, which is shared with the uart isr. */
+	struct k_spinlock tx_lock;
+	/* Part of the transmit buffer that still needs to be given to the uart isr. */
+	const uint8_t *tx_buf;
+	size_t tx_len;
+	bool tx_active;
+	/* Given by the uart isr, once the whole transmit buffer was sent out. */
+	struct k_sem tx_done;
+	/* Given by the uart isr, whenever something is received. */
+	struct k_sem rx_sem;
+	/* Something was transmitted and the end of its response was not received yet, so note-c
+	 * delays end as soon as something is received. */
+	bool rx_wake_armed;
+};
+#endif
+
+extern int notecard_uart_init(const struct notecard_bus *bus);
 extern void notecard_uart_attach_bus_api(const struct notecard_bus *bus);
+extern bool notecard_uart_is_present(const struct notecard_bus *bus, k_timeout_t timeout);
+extern int notecard_uart_write(const struct notecard_bus *bus, const uint8_t *buf, size_t len);
+extern int notecard_uart_read(const struct notecard_bus *bus, uint8_t *buf, size_t size);
+#if CONFIG_NOTECARD_RX_WAKE
+extern void notecard_uart_rx_wait(const struct notecard_bus *bus, k_timeout_t timeout);
+#endif
 #endif
 
 #if NOTECARD_BUS_I2C
+struct notecard_i2c_data {
+	/* I2C controller rejected scatter/gather messages (e.g. nRF TWIM with too small
+	 * zephyr,concat-buf-size), so chunks are staged in a single buffer on stack. */
+	bool single_buf;
+};
+
+extern int notecard_i2c_init(const struct notecard_bus *bus);
 extern void notecard_i2c_attach_bus_api(const struct notecard_bus *bus);
+extern bool notecard_i2c_is_present(const struct notecard_bus *bus, k_timeout_t timeout);
+extern int notecard_i2c_write(const struct notecard_bus *bus, const uint8_t *buf, size_t len);
+extern int notecard_i2c_read(const struct notecard_bus *bus, uint8_t *buf, size_t size);
+#endif
+
+#if CONFIG_NOTECARD_REPLAY
+extern int notecard_replay_init(const struct notecard_bus *bus);
+extern void notecard_replay_attach_bus_api(const struct notecard_bus *bus);
+extern bool notecard_replay_is_present(const struct notecard_bus *bus, k_timeout_t timeout);
+extern int notecard_replay_write(const struct notecard_bus *bus, const uint8_t *buf, size_t len);
+extern int notecard_replay_read(const struct notecard_bus *bus, uint8_t *buf, size_t size);
+#if CONFIG_NOTECARD_RX_WAKE
+extern void notecard_replay_rx_wait(const struct notecard_bus *bus, k_timeout_t timeout);
+#endif
 #endif
 
 struct notecard_config {
 	struct notecard_bus bus;
 	struct gpio_dt_spec attn_p_gpio;
 	bool attn_gpio_in_use;
+	/* Buffer of the heap that note-c uses while this instance has control. */
+	uint8_t *heap_buf;
+	size_t heap_size;
+#if CONFIG_NOTECARD_ASYNC
+	/* Stack of the worker thread that executes submitted requests. */
+	k_thread_stack_t *async_stack;
+#endif
+#if CONFIG_NOTECARD_QUEUE
+	/* Flash area of the offline note queue, -1 if the instance has none. */
+	int queue_partition_id;
+#endif
+};
+
+struct notecard_heap {
+	struct k_heap heap;
+	uint8_t *buf;
+	size_t size;
+	/* Number of live allocations and number of failed allocations. */
+	atomic_t num_allocs;
+	atomic_t alloc_failures;
+#if !CONFIG_SYS_HEAP_RUNTIME_STATS
+	/* Usable bytes of live allocations, heap only counts them itself with runtime stats. */
+	atomic_t allocated_bytes;
+#endif
 };
 
 struct notecard_callback_data {
@@ -58,6 +179,150 @@ struct notecard_callback_data {
 	void *user_data;
 };
 
+#if CONFIG_NOTECARD_ASYNC
+struct notecard_async_req {
+	/* Request that was given to notecard_request_submit(). */
+	J *req;
+	/* Callback and user data that were given to notecard_request_submit(). */
+	notecard_rsp_cb_t cb;
+	void *user_data;
+};
+
+struct notecard_async_data {
+	struct k_msgq queue;
+	char __aligned(4) queue_buf[CONFIG_NOTECARD_ASYNC_QUEUE_DEPTH *
+				    sizeof(struct notecard_async_req)];
+#if CONFIG_NOTECARD_ASYNC_QUEUE_FULL_DROP_OLDEST
+	/* Dropped requests, whose callbacks still need to be called by the worker. */
+	struct k_msgq dropped;
+	char __aligned(4) dropped_buf[CONFIG_NOTECARD_ASYNC_QUEUE_DEPTH *
+				      sizeof(struct notecard_async_req)];
+#endif
+	struct k_thread thread;
+};
+
+extern int notecard_async_init(const struct device *dev);
+#endif
+
+#if CONFIG_NOTECARD_ATTN_DEFERRED
+struct notecard_attn_data {
+	struct k_work work;
+	/* Workqueue that the work is submitted to. */
+	struct k_work_q *workq;
+	/* Raised from the isr for every attn event. */
+	struct k_poll_signal signal;
+	/* Number of attn events that were not yet dispatched to the callback. */
+	atomic_t pending;
+
+	/* Protects the timestamp and the event. */
+	struct k_spinlock lock;
+	/* Uptime of the latest attn event. */
+	int64_t last_timestamp;
+	/* Event that was dispatched to the callback last. */
+	struct notecard_attn_event event;
+};
+
+/**
+ * @brief Initialize deferred dispatch of attn events.
+ */
+void notecard_attn_init(const struct device *dev);
+
+/**
+ * @brief Record attn event and schedule the callback, called from the isr.
+ */
+void notecard_attn_dispatch(const struct device *dev);
+#endif
+
+#if CONFIG_NOTECARD_CACHE
+struct notecard_cache_entry {
+	/* Whole JSON text of the request, empty if entry is not used. */
+	char req[CONFIG_NOTECARD_CACHE_REQ_MAX_LEN + 1];
+	char rsp[CONFIG_NOTECARD_CACHE_RSP_MAX_LEN + 1];
+	k_timepoint_t expires;
+};
+
+struct notecard_cache_flight {
+	/* Request that is being sent, NULL once it is done. */
+	const char *req;
+	/* Number of threads that use the slot: the one that sends the request until it is done
+	 * and the ones that wait for the response until they copy it. Slot is free when 0. */
+	uint32_t refs;
+	/* Result of the request and its response, valid once done is set. */
+	int rc;
+	bool done;
+	/* Response did not fit into rsp, waiting threads need to send the request themselves. */
+	bool rsp_dropped;
+	char rsp[CONFIG_NOTECARD_CACHE_RSP_MAX_LEN + 1];
+};
+
+struct notecard_cache_data {
+	/* Protects all fields below. Mutex, since whole requests and responses are copied while
+	 * holding it. */
+	struct k_mutex lock;
+	struct notecard_cache_entry entries[CONFIG_NOTECARD_CACHE_ENTRIES];
+	uint32_t hits;
+	uint32_t misses;
+	uint32_t coalesced;
+
+#if CONFIG_NOTECARD_CACHE_COALESCE_SLOTS
+	/* Protects requests in flight. */
+	struct k_mutex flight_lock;
+	/* Signaled when a request in flight is done. */
+	struct k_condvar flight_cond;
+	struct notecard_cache_flight flights[CONFIG_NOTECARD_CACHE_COALESCE_SLOTS];
+#endif
+};
+
+/**
+ * @brief Initialize response cache of a notecard instance.
+ */
+void notecard_cache_init(const struct device *dev);
+#endif
+
+#if CONFIG_NOTECARD_QUEUE
+struct notecard_queue_data {
+	/* Protects all fields below and the flash circular buffer. */
+	struct k_mutex lock;
+	struct fcb fcb;
+	struct flash_sector sectors[CONFIG_NOTECARD_QUEUE_MAX_SECTORS];
+	/* Last drained entry, fe_sector is NULL if nothing was drained. */
+	struct fcb_entry cursor;
+	struct notecard_queue_stats stats;
+	/* Queue was initialized. */
+	bool ready;
+
+	struct k_work_delayable drain_work;
+	/* Note that is being sent, only used by the drain work. */
+	char note[CONFIG_NOTECARD_QUEUE_NOTE_MAX_LEN + 1];
+};
+
+/**
+ * @brief Initialize offline note queue of a notecard instance and schedule sending of notes
+ * that were queued before the reboot. Queue stays disabled if this fails.
+ */
+void notecard_queue_init(const struct device *dev);
+#endif
+
+#if CONFIG_NOTECARD_SCHEMA
+struct notecard_schema_data {
+	/* Schemas whose note.template was registered, protected by the control of the notecard. */
+	const struct notecard_schema *registered[CONFIG_NOTECARD_SCHEMA_MAX_COUNT];
+	size_t count;
+};
+#endif
+
+#if CONFIG_NOTECARD_STATS
+struct notecard_stats_data {
+	/* Protects all fields below. */
+	struct k_spinlock lock;
+	struct notecard_stats stats;
+	/* Cycle count at the end of the last transmission, response wait is measured from it. */
+	uint32_t rx_wait_start;
+	/* Response to the last transmission was not received yet. */
+	bool rx_wait_pending;
+};
+#endif
+
 struct notecard_data {
 	/* Internal gpio_cb structure */
 	struct gpio_callback gpio_cb;
@@ -69,8 +334,398 @@ struct notecard_data {
 
 	/* Pointer to the container device. */
 	const struct device *dev;
+
+	/* Heap that note-c uses while this instance has control. */
+	struct notecard_heap heap;
+
+	/* Notecard responded to the last presence check. */
+	bool ready;
+
+	/* Earliest time when the next chunk of a raw transmission can be sent, so chunks are paced
+	 * across separate writes and requests. */
+	k_timepoint_t tx_chunk_next;
+
+#if CONFIG_NOTECARD_ASYNC
+	struct notecard_async_data async;
+#endif
+
+#if CONFIG_NOTECARD_ATTN_DEFERRED
+	struct notecard_attn_data attn;
+#endif
+
+#if CONFIG_NOTECARD_STATS
+	struct notecard_stats_data stats;
+#endif
+
+#if CONFIG_NOTECARD_CACHE
+	struct notecard_cache_data cache;
+#endif
+
+#if CONFIG_NOTECARD_QUEUE
+	struct notecard_queue_data queue;
+#endif
+
+#if CONFIG_NOTECARD_SCHEMA
+	struct notecard_schema_data schema;
+#endif
+};
+
+/**
+ * @brief Initialize a heap of a notecard instance and register it with the allocator.
+ */
+void notecard_alloc_init(struct notecard_heap *heap, uint8_t *buf, size_t size);
+
+/**
+ * @brief Zephyr-specific `malloc` function required by the note-c lib.
+ *
+ * Memory is allocated from the heap of the instance that the calling thread has control of.
+ * Allocation fails if the calling thread has no control.
+ */
+void *notecard_malloc(size_t size);
+
+/**
+ * @brief Zephyr-specific `free` function required by the note-c lib.
+ */
+void notecard_free(void *mem);
+
+/**
+ * @brief Zephyr-specific `log print` function required by the note-c lib.
+ *
+ * Forwards note-c debug output to the notecard log module, with the level taken from the
+ * "[ERROR]", "[WARN]", "[INFO]" or "[DEBUG]" prefix that note-c outputs before the message.
+ */
+size_t notecard_log_print(const char *message);
+
+/**
+ * @brief State of a raw transmission to the notecard, which bypasses note-c.
+ */
+struct notecard_transport {
+	const struct device *dev;
+	const struct notecard_bus *bus;
+	/* Number of bytes sent in the current segment. */
+	size_t segment_len;
 };
 
+/**
+ * @brief Start a raw transmission to the notecard.
+ *
+ * Anything that the notecard sent and nobody read is dropped, so it is not mistaken for the
+ * response. Caller needs to have the control of the notecard.
+ *
+ * @param[out] tp	Transport state.
+ * @param[in] dev	Device struct of notecard driver instance.
+ */
+void notecard_transport_init(struct notecard_transport *tp, const struct device *dev);
+
+/**
+ * @brief Transmit raw bytes to the notecard.
+ *
+ * Can be called several times for the same request, data is paced in segments across the
+ * calls. Data is split into chunks that the bus can transmit at once, every chunk that follows
+ * another one waits for the chunk delay of the bus, also across calls.
+ *
+ * @return 0 on success, negative error code otherwise.
+ */
+int notecard_transport_write(struct notecard_transport *tp, const void *buf, size_t len);
+
+/**
+ * @brief Drop everything that the notecard sent and nobody read.
+ */
+void notecard_transport_rx_flush(struct notecard_transport *tp);
+
+/**
+ * @brief Serialize the request and transmit it to the notecard, terminated with a newline.
+ *
+ * @param[in] req	Request or command, it is freed by this function.
+ *
+ * @retval 0 on success.
+ * @retval -ENOMEM if the request could not be serialized.
+ * @retval -EIO if the communication bus failed.
+ */
+int notecard_transport_write_json(struct notecard_transport *tp, J *req);
+
+/**
+ * @brief Receive raw bytes from the notecard, without blocking.
+ *
+ * @return Number of received bytes (0 if nothing is available) or negative error code.
+ */
+int notecard_transport_read(struct notecard_transport *tp, uint8_t *buf, size_t size);
+
+/**
+ * @brief Receive a single line (i.e. response) from the notecard.
+ *
+ * Line is null-terminated, without the trailing "\r\n".
+ *
+ * @param[out] buf	Buffer for the line.
+ * @param[in] size	Size of the buffer.
+ * @param[in] timeout	How long to wait for the whole line.
+ *
+ * @return Length of the line on success, -ETIMEDOUT if the line did not arrive in time,
+ * -EMSGSIZE if it did not fit into the buffer (rest of the line is dropped), other negative error
+ * code on bus error.
+ */
+int notecard_transport_read_line(struct notecard_transport *tp, char *buf, size_t size,
+				 k_timeout_t timeout);
+
+/**
+ * @brief Write key of a field to the request, its JSON value is written with
+ * notecard_writer_put().
+ */
+void notecard_writer_put_key(struct notecard_writer *w, const char *key);
+
+/**
+ * @brief Write raw JSON text, for example a value after notecard_writer_put_key().
+ */
+void notecard_writer_put(struct notecard_writer *w, const char *data, size_t len);
+
+#if CONFIG_NOTECARD_JSON_PARSER
+/**
+ * @brief State of a streaming JSON parser.
+ */
+struct notecard_json_parser {
+	notecard_json_cb_t cb;
+	void *user_data;
+	/* First non-zero value returned by the callback, callback is not called anymore after it. */
+	int cb_err;
+
+	uint8_t state;
+	uint8_t depth;
+	/* Bit for every nesting level that is an object (otherwise it is an array). */
+	uint32_t is_object;
+
+	/* String that is being parsed is a key. */
+	bool in_key;
+	/* Value that is being parsed belongs to a key. */
+	bool has_key;
+	/* Code unit of a "\uXXXX" escape sequence and number of its parsed digits. */
+	uint16_t unicode;
+	uint8_t unicode_len;
+	/* High surrogate that waits for its low surrogate, 0 if there is none. */
+	uint16_t high_surrogate;
+
+	size_t key_len;
+	char key[CONFIG_NOTECARD_JSON_KEY_MAX_LEN + 1];
+	size_t value_len;
+	char value[CONFIG_NOTECARD_JSON_VALUE_MAX_LEN + 1];
+};
+
+/**
+ * @brief Initialize streaming JSON parser.
+ */
+void notecard_json_parser_init(struct notecard_json_parser *p, notecard_json_cb_t cb,
+			       void *user_data);
+
+/**
+ * @brief Parse next part of the JSON, callback is called for every complete field.
+ */
+void notecard_json_parser_feed(struct notecard_json_parser *p, const char *buf, size_t len);
+
+/**
+ * @brief Finish parsing.
+ *
+ * @return 0 on success, -EBADMSG if JSON was malformed or incomplete, otherwise non-zero value
+ * that the callback returned.
+ */
+int notecard_json_parser_finish(struct notecard_json_parser *p);
+
+/**
+ * @brief Receive a single line (i.e. response) from the notecard and parse it on the fly.
+ *
+ * @return Same as notecard_json_parser_finish(), -ETIMEDOUT if the line did not arrive in time,
+ * other negative error code on bus error.
+ */
+int notecard_transport_read_parse(struct notecard_transport *tp, struct notecard_json_parser *p,
+				  k_timeout_t timeout);
+#endif
+
+#if CONFIG_NOTECARD_BINARY
+/**
+ * @brief State of a streaming COBS encoder.
+ *
+ * Every encoded byte is XOR-ed with the newline, so the encoded data contains no newlines and is
+ * terminated with one.
+ */
+struct notecard_cobs_encoder {
+	const uint8_t *data;
+	size_t len;
+	/* Start of the current block in the data and number of its non-zero bytes. */
+	size_t pos;
+	size_t block_len;
+	/* Next byte of the current block to output, 0 is its code byte. */
+	size_t block_pos;
+	/* Terminating newline was output. */
+	bool done;
+};
+
+/**
+ * @brief Initialize streaming COBS encoder, data needs to stay valid until it is encoded.
+ */
+void notecard_cobs_encoder_init(struct notecard_cobs_encoder *enc, const uint8_t *data,
+				size_t len);
+
+/**
+ * @brief Encode next part of the data.
+ *
+ * @return Number of encoded bytes written to the output, 0 once the whole data and its
+ * terminating newline were output.
+ */
+size_t notecard_cobs_encode(struct notecard_cobs_encoder *enc, uint8_t *out, size_t size);
+
+/**
+ * @brief Get COBS encoded length of the data, without the terminating newline.
+ */
+size_t notecard_cobs_encoded_len(const uint8_t *data, size_t len);
+
+/**
+ * @brief State of a streaming COBS decoder, which decodes directly into the given buffer.
+ */
+struct notecard_cobs_decoder {
+	uint8_t *buf;
+	size_t size;
+	size_t len;
+	/* Number of non-zero bytes left in the current block. */
+	size_t block_left;
+	/* Zero that the code byte of the current block replaced, it is only output if another
+	 * block follows. */
+	bool zero_pending;
+};
+
+/**
+ * @brief Initialize streaming COBS decoder.
+ */
+void notecard_cobs_decoder_init(struct notecard_cobs_decoder *dec, uint8_t *buf, size_t size);
+
+/**
+ * @brief Decode next byte, as it was received. Terminating newline is not given to the decoder.
+ *
+ * @retval 0 on success.
+ * @retval -EBADMSG if the byte is a zero code byte.
+ * @retval -EMSGSIZE if decoded data does not fit into the buffer.
+ */
+int notecard_cobs_decode(struct notecard_cobs_decoder *dec, uint8_t c);
+
+/**
+ * @brief Finish decoding, after the terminating newline was received.
+ *
+ * @return Number of decoded bytes, -EBADMSG if data ended in the middle of a block.
+ */
+int notecard_cobs_decoder_finish(struct notecard_cobs_decoder *dec);
+#endif
+
+enum notecard_stats_latency {
+	NOTECARD_STATS_LOCK_WAIT,
+	NOTECARD_STATS_LOCK_HOLD,
+	NOTECARD_STATS_TX,
+	NOTECARD_STATS_RX_WAIT,
+	NOTECARD_STATS_PARSE,
+};
+
+#if CONFIG_NOTECARD_STATS
+
+/**
+ * @brief Get the start of a measured interval.
+ */
+static inline uint32_t notecard_stats_now(void)
+{
+	return k_cycle_get_32();
+}
+
+/**
+ * @brief Record duration of an interval, which started at the given cycle count.
+ */
+void notecard_stats_latency(const struct device *dev, enum notecard_stats_latency id,
+			    uint32_t start);
+
+/**
+ * @brief Record a transmission, which started at the given cycle count.
+ *
+ * Response wait of the instance is measured from the end of the transmission.
+ *
+ * @param[in] dev	Device struct of notecard driver instance, NULL if the calling thread does
+ *			not have the control.
+ * @param[in] len	Number of transmitted bytes.
+ * @param[in] start	Cycle count at the start of the transmission.
+ * @param[in] err	Error code of the transmission, 0 on success.
+ */
+void notecard_stats_tx(const struct device *dev, size_t len, uint32_t start, int err);
+
+/**
+ * @brief Record a reception.
+ *
+ * @param[in] dev	Device struct of notecard driver instance, NULL if the calling thread does
+ *			not have the control.
+ * @param[in] len	Number of received bytes.
+ * @param[in] eol	Received bytes contained the end of the response.
+ * @param[in] err	Error code of the reception, 0 on success.
+ */
+void notecard_stats_rx(const struct device *dev, size_t len, bool eol, int err);
+
+/**
+ * @brief Record that waiting for the control timed out.
+ */
+void notecard_stats_ctrl_timeout(const struct device *dev);
+#else
+/* Statistics are compiled out, so instrumented code does not need to be guarded. */
+static inline uint32_t notecard_stats_now(void)
+{
+	return 0;
+}
+
+static inline void notecard_stats_latency(const struct device *dev,
+					  enum notecard_stats_latency id, uint32_t start)
+{
+}
+
+static inline void notecard_stats_tx(const struct device *dev, size_t len, uint32_t start,
+				     int err)
+{
+}
+
+static inline void notecard_stats_rx(const struct device *dev, size_t len, bool eol, int err)
+{
+}
+
+static inline void notecard_stats_ctrl_timeout(const struct device *dev)
+{
+}
+#endif
+
+/**
+ * @brief Get timestamp of a captured record.
+ */
+static inline uint32_t notecard_capture_timestamp(void)
+{
+	return (uint32_t)k_ticks_to_us_floor64(k_uptime_ticks());
+}
+
+#if CONFIG_NOTECARD_CAPTURE
+/**
+ * @brief Capture bytes that were transmitted to the notecard.
+ */
+void notecard_capture_tx(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Capture bytes that were received from the notecard.
+ */
+void notecard_capture_rx(const uint8_t *buf, size_t len);
+#else
+static inline void notecard_capture_tx(const uint8_t *buf, size_t len)
+{
+}
+
+static inline void notecard_capture_rx(const uint8_t *buf, size_t len)
+{
+}
+#endif
+
+/**
+ * @brief Get the notecard instance that the calling thread has control of.
+ *
+ * @return Device struct of notecard driver instance or NULL if the calling thread does not have
+ * the control.
+ */
+const struct device *notecard_ctrl_owner(void);
+
 #ifdef __cplusplus
 }
 #endif
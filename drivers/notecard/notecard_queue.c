@@ -0,0 +1,533 @@
+/** @file notecard_queue.c
+ *
+ * @brief Flash-backed offline note queue, drained to the notecard in batches.
+ *
+ * Notes are entries of a flash circular buffer. After every sent batch, a marker entry with the
+ * position of the last sent note is appended, so it is known which notes were sent after a
+ * reboot. Sectors whose notes were all sent are erased.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/drivers/flash.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* "NTCQ" */
+#define QUEUE_FCB_MAGIC	  0x4e544351
+#define QUEUE_FCB_VERSION 1
+
+/* Marker entry starts with a zero byte, notes are JSON and never start with it. */
+struct queue_marker {
+	uint8_t zero;
+	/* Position of the last sent entry. */
+	uint8_t sector;
+	uint32_t elem_off;
+} __packed;
+
+static K_KERNEL_STACK_DEFINE(prv_queue_workq_stack, CONFIG_NOTECARD_QUEUE_WORKQ_STACK_SIZE);
+static struct k_work_q prv_queue_workq;
+
+/**
+ * @brief Start the workqueue that drains the queues, it is shared by all instances.
+ *
+ * Called only from the driver initialization, which runs in a single thread.
+ */
+static void prv_workq_start(void)
+{
+	static bool started;
+
+	if (started) {
+		return;
+	}
+
+	struct k_work_queue_config cfg = {
+		.name = "notecard_queue",
+	};
+
+	k_work_queue_start(&prv_queue_workq, prv_queue_workq_stack,
+			   K_KERNEL_STACK_SIZEOF(prv_queue_workq_stack),
+			   K_PRIO_PREEMPT(CONFIG_NOTECARD_QUEUE_WORKQ_PRIORITY), &cfg);
+	started = true;
+}
+
+/**
+ * @brief Split the partition into FCB sectors.
+ *
+ * Consecutive flash pages are grouped into sectors of at least 1/CONFIG_NOTECARD_QUEUE_MAX_SECTORS
+ * of the partition, so a partition with more pages than that still fits.
+ *
+ * @param[in] partition_id	Flash partition of the queue.
+ * @param[out] sectors		Sectors, offsets are relative to the partition.
+ * @param[in,out] cnt		Size of the sectors array, number of sectors on return.
+ *
+ * @return 0 on success, -ENOMEM if uneven pages do not fit into the sectors array, other negative
+ * error code otherwise.
+ */
+static int prv_sectors_get(int partition_id, struct flash_sector *sectors, uint32_t *cnt)
+{
+	const struct flash_area *fa;
+
+	int rc = flash_area_open(partition_id, &fa);
+	if (rc) {
+		return rc;
+	}
+
+	const struct device *flash = flash_area_get_device(fa);
+	size_t min_size = DIV_ROUND_UP(fa->fa_size, *cnt);
+	uint32_t used = 0;
+	off_t off = 0;
+
+	while (off < fa->fa_size) {
+		struct flash_pages_info info;
+
+		rc = flash_get_page_info_by_offs(flash, fa->fa_off + off, &info);
+		if (rc) {
+			break;
+		}
+
+		if (used == 0 || sectors[used - 1].fs_size >= min_size) {
+			if (used == *cnt) {
+				rc = -ENOMEM;
+				break;
+			}
+
+			sectors[used++] = (struct flash_sector){.fs_off = off, .fs_size = 0};
+		}
+
+		sectors[used - 1].fs_size += info.size;
+		off += info.size;
+	}
+
+	flash_area_close(fa);
+	*cnt = used;
+
+	return rc;
+}
+
+/**
+ * @brief Read the entry if it is a marker, caller needs to hold the queue lock.
+ *
+ * @return true if the entry is a marker, false if it is a note.
+ */
+static bool prv_marker_read(struct notecard_queue_data *q, struct fcb_entry *loc,
+			    struct queue_marker *marker)
+{
+	if (loc->fe_data_len != sizeof(*marker)) {
+		return false;
+	}
+
+	int rc = flash_area_read(q->fcb.fap, FCB_ENTRY_FA_DATA_OFF((*loc)), marker,
+				 sizeof(*marker));
+
+	return rc == 0 && marker->zero == 0;
+}
+
+static bool prv_is_marker(struct notecard_queue_data *q, struct fcb_entry *loc)
+{
+	struct queue_marker marker;
+
+	return prv_marker_read(q, loc, &marker);
+}
+
+/**
+ * @brief Restore the cursor from the last marker, caller needs to hold the queue lock.
+ */
+static void prv_cursor_restore(struct notecard_queue_data *q)
+{
+	struct fcb_entry loc = {0};
+	struct queue_marker marker;
+	struct queue_marker last;
+	bool found = false;
+
+	while (fcb_getnext(&q->fcb, &loc) == 0) {
+		if (prv_marker_read(q, &loc, &marker)) {
+			last = marker;
+			found = true;
+		}
+	}
+
+	q->cursor.fe_sector = NULL;
+
+	if (!found || last.sector >= q->fcb.f_sector_cnt) {
+		return;
+	}
+
+	/* If the entry is not found, its sector was dropped and all remaining notes were not sent
+	 * yet. */
+	loc = (struct fcb_entry){0};
+
+	while (fcb_getnext(&q->fcb, &loc) == 0) {
+		if (loc.fe_sector == &q->sectors[last.sector] && loc.fe_elem_off == last.elem_off) {
+			q->cursor = loc;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Count notes after the cursor, caller needs to hold the queue lock.
+ */
+static uint32_t prv_depth_count(struct notecard_queue_data *q)
+{
+	struct fcb_entry loc = q->cursor;
+	uint32_t depth = 0;
+
+	while (fcb_getnext(&q->fcb, &loc) == 0) {
+		if (!prv_is_marker(q, &loc)) {
+			depth++;
+		}
+	}
+
+	return depth;
+}
+
+/**
+ * @brief Append an entry, caller needs to hold the queue lock.
+ *
+ * @return 0 on success, -ENOSPC if the queue is full, other negative error code otherwise.
+ */
+static int prv_append(struct notecard_queue_data *q, const void *buf, size_t len)
+{
+	struct fcb_entry loc;
+
+	int rc = fcb_append(&q->fcb, len, &loc);
+	if (rc) {
+		return rc;
+	}
+
+	rc = flash_area_write(q->fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), buf, len);
+	if (rc) {
+		return rc;
+	}
+
+	return fcb_append_finish(&q->fcb, &loc);
+}
+
+/**
+ * @brief Erase the oldest sector, dropping the notes in it that were not sent yet. Caller needs
+ * to hold the queue lock.
+ */
+static int prv_drop_oldest(struct notecard_queue_data *q)
+{
+	bool cursor_dropped = q->cursor.fe_sector == NULL || q->cursor.fe_sector == q->fcb.f_oldest;
+
+	int rc = fcb_rotate(&q->fcb);
+	if (rc) {
+		return rc;
+	}
+
+	if (cursor_dropped) {
+		/* Remaining notes were not sent yet. */
+		q->cursor.fe_sector = NULL;
+	}
+
+	uint32_t depth = prv_depth_count(q);
+
+	q->stats.dropped += q->stats.depth - depth;
+	q->stats.depth = depth;
+
+	return 0;
+}
+
+/**
+ * @brief Erase sectors whose notes were all sent, caller needs to hold the queue lock.
+ */
+static void prv_compact(struct notecard_queue_data *q)
+{
+	while (q->cursor.fe_sector && q->cursor.fe_sector != q->fcb.f_oldest) {
+		if (fcb_rotate(&q->fcb)) {
+			return;
+		}
+	}
+}
+
+/**
+ * @brief Send a single note and read its response.
+ *
+ * @retval 0 if the note was sent.
+ * @retval -EBADMSG if the notecard responded with an error.
+ * @retval -errno Other negative errno code if the communication bus failed.
+ */
+static int prv_send(const struct device *dev, const char *req)
+{
+	struct notecard_transport tp;
+	char rsp[64];
+
+	notecard_transport_init(&tp, dev);
+
+	int rc = notecard_transport_write(&tp, req, strlen(req));
+	if (!rc) {
+		rc = notecard_transport_write(&tp, "\n", 1);
+	}
+	if (!rc) {
+		rc = notecard_transport_read_line(&tp, rsp, sizeof(rsp),
+						  K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+	}
+
+	/* Only the start of the response is needed to tell if it is an error. */
+	if (rc < 0 && rc != -EMSGSIZE) {
+		return rc;
+	}
+
+	return strstr(rsp, "\"err\":") ? -EBADMSG : 0;
+}
+
+/**
+ * @brief Send a batch of notes under a single control take.
+ *
+ * @return 0 on success, negative error code if the notecard was not available or sending failed.
+ */
+static int prv_drain_batch(const struct device *dev, struct notecard_queue_data *q, bool *more)
+{
+	uint32_t start = k_uptime_get_32();
+	uint32_t sent = 0;
+	int rc = 0;
+
+	*more = false;
+
+	/* Notecard might be busy with a long request of another thread, try again later. */
+	if (notecard_ctrl_take_timeout(dev, K_NO_WAIT)) {
+		return -EBUSY;
+	}
+
+	if (!notecard_is_present(dev)) {
+		notecard_ctrl_release(dev);
+		return -ENODEV;
+	}
+
+	while (sent < CONFIG_NOTECARD_QUEUE_BATCH_SIZE) {
+		struct fcb_entry loc;
+		bool marker = false;
+		bool oversized = false;
+
+		k_mutex_lock(&q->lock, K_FOREVER);
+
+		loc = q->cursor;
+		rc = fcb_getnext(&q->fcb, &loc);
+		if (rc == 0) {
+			marker = prv_is_marker(q, &loc);
+			/* Entry was not written by notecard_queue_add(), e.g. it is corrupted or the
+			 * maximum note length was lowered since. */
+			oversized = !marker && loc.fe_data_len > sizeof(q->note) - 1;
+		}
+		if (rc == 0 && !marker && !oversized) {
+			rc = flash_area_read(q->fcb.fap, FCB_ENTRY_FA_DATA_OFF(loc), q->note,
+					     loc.fe_data_len);
+			q->note[loc.fe_data_len] = '\0';
+		}
+
+		k_mutex_unlock(&q->lock);
+
+		if (rc == -ENOTSUP) {
+			/* Queue is empty. */
+			rc = 0;
+			break;
+		}
+		if (rc) {
+			LOG_ERR("Failed to read queued note (err=%d)", rc);
+			break;
+		}
+
+		if (oversized) {
+			LOG_WRN("Queued note too long (%u B), skipped", loc.fe_data_len);
+		} else if (!marker) {
+			rc = prv_send(dev, q->note);
+			if (rc == -EBADMSG) {
+				LOG_WRN("Queued note rejected by the notecard: %s", q->note);
+			} else if (rc) {
+				LOG_ERR("Failed to send queued note (err=%d)", rc);
+				break;
+			}
+
+			sent++;
+		}
+
+		k_mutex_lock(&q->lock, K_FOREVER);
+
+		/* Sector of the entry could be dropped by a producer while the note was sent, the
+		 * cursor only moves if the entry is still the next one. */
+		struct fcb_entry next = q->cursor;
+
+		if (fcb_getnext(&q->fcb, &next) == 0 && next.fe_sector == loc.fe_sector &&
+		    next.fe_elem_off == loc.fe_elem_off) {
+			q->cursor = loc;
+			q->stats.depth -= !marker;
+		}
+
+		q->stats.drained += !marker && !oversized && rc == 0;
+		q->stats.rejected += !marker && rc == -EBADMSG;
+		q->stats.dropped += oversized;
+
+		k_mutex_unlock(&q->lock);
+		rc = 0;
+	}
+
+	notecard_ctrl_release(dev);
+
+	uint32_t elapsed_ms = k_uptime_get_32() - start;
+
+	k_mutex_lock(&q->lock, K_FOREVER);
+
+	if (sent > 0 && q->cursor.fe_sector) {
+		struct queue_marker marker = {
+			.sector = q->cursor.fe_sector - q->sectors,
+			.elem_off = q->cursor.fe_elem_off,
+		};
+
+		q->stats.drain_rate = (sent * MSEC_PER_SEC) / MAX(elapsed_ms, 1);
+
+		prv_compact(q);
+		if (prv_append(q, &marker, sizeof(marker))) {
+			/* Notes of this batch are sent again after a reboot. */
+			LOG_WRN("Failed to mark queued notes as sent");
+		}
+	}
+
+	*more = q->stats.depth > 0;
+
+	k_mutex_unlock(&q->lock);
+
+	return rc;
+}
+
+static void prv_drain_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct notecard_queue_data *q = CONTAINER_OF(dwork, struct notecard_queue_data, drain_work);
+	struct notecard_data *data = CONTAINER_OF(q, struct notecard_data, queue);
+	bool more;
+
+	int rc = prv_drain_batch(data->dev, q, &more);
+	if (rc) {
+		k_work_reschedule_for_queue(&prv_queue_workq, dwork,
+					    K_MSEC(CONFIG_NOTECARD_QUEUE_RETRY_MS));
+	} else if (more) {
+		/* Control is released between batches, so other threads get the notecard. */
+		k_work_reschedule_for_queue(&prv_queue_workq, dwork, K_NO_WAIT);
+	}
+}
+
+void notecard_queue_init(const struct device *dev)
+{
+	const struct notecard_config *config = dev->config;
+	struct notecard_data *data = dev->data;
+	struct notecard_queue_data *q = &data->queue;
+
+	if (config->queue_partition_id < 0) {
+		return;
+	}
+
+	uint32_t sector_cnt = ARRAY_SIZE(q->sectors);
+
+	int rc = prv_sectors_get(config->queue_partition_id, q->sectors, &sector_cnt);
+	if (rc) {
+		LOG_ERR("Failed to get queue partition sectors, queue disabled (err=%d)", rc);
+		return;
+	}
+
+	q->fcb.f_magic = QUEUE_FCB_MAGIC;
+	q->fcb.f_version = QUEUE_FCB_VERSION;
+	q->fcb.f_sector_cnt = sector_cnt;
+	q->fcb.f_sectors = q->sectors;
+
+	rc = fcb_init(config->queue_partition_id, &q->fcb);
+	if (rc) {
+		LOG_ERR("Failed to initialize queue, queue disabled (err=%d)", rc);
+		return;
+	}
+
+	k_mutex_init(&q->lock);
+	k_work_init_delayable(&q->drain_work, prv_drain_work_handler);
+	prv_workq_start();
+
+	prv_cursor_restore(q);
+	q->stats.depth = prv_depth_count(q);
+	q->ready = true;
+
+	if (q->stats.depth > 0) {
+		LOG_INF("%u queued notes from before the reboot", q->stats.depth);
+		k_work_schedule_for_queue(&prv_queue_workq, &q->drain_work,
+					  K_MSEC(CONFIG_NOTECARD_QUEUE_DRAIN_DELAY_MS));
+	}
+}
+
+int notecard_queue_add(const struct device *dev, const char *req)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_queue_data *q = &data->queue;
+	size_t len = strlen(req);
+
+	if (!q->ready) {
+		return -ENOTSUP;
+	}
+
+	if (len == 0 || len > CONFIG_NOTECARD_QUEUE_NOTE_MAX_LEN) {
+		return -EMSGSIZE;
+	}
+
+	k_mutex_lock(&q->lock, K_FOREVER);
+
+	int rc = prv_append(q, req, len);
+
+	/* Queue is full, make space by dropping the oldest notes. */
+	while (rc == -ENOSPC) {
+		rc = prv_drop_oldest(q);
+		if (!rc) {
+			rc = prv_append(q, req, len);
+		}
+	}
+
+	if (!rc) {
+		q->stats.depth++;
+		q->stats.added++;
+	}
+
+	k_mutex_unlock(&q->lock);
+
+	if (rc) {
+		LOG_ERR("Failed to queue note (err=%d)", rc);
+		return rc;
+	}
+
+	/* Does not postpone the drain if it is already scheduled. */
+	k_work_schedule_for_queue(&prv_queue_workq, &q->drain_work,
+				  K_MSEC(CONFIG_NOTECARD_QUEUE_DRAIN_DELAY_MS));
+
+	return 0;
+}
+
+void notecard_queue_drain(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_queue_data *q = &data->queue;
+
+	if (q->ready) {
+		k_work_reschedule_for_queue(&prv_queue_workq, &q->drain_work, K_NO_WAIT);
+	}
+}
+
+int notecard_queue_stats_get(const struct device *dev, struct notecard_queue_stats *stats)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_queue_data *q = &data->queue;
+
+	if (!q->ready) {
+		return -ENOTSUP;
+	}
+
+	k_mutex_lock(&q->lock, K_FOREVER);
+	*stats = q->stats;
+	k_mutex_unlock(&q->lock);
+
+	return 0;
+}
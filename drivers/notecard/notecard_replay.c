@@ -0,0 +1,310 @@
+/** @file notecard_replay.c
+ *
+ * @brief Bus that replays a captured session instead of talking to the notecard.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <note.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* Session that is replayed, set with notecard_replay_load(). Replay state is only touched by
+ * the instance that has the control, so it needs no locking. */
+static const uint8_t *prv_session;
+static size_t prv_session_len;
+
+/* Offset of the current record and offset of the next byte in its payload. */
+static size_t prv_pos;
+static size_t prv_rec_pos;
+
+/* Captured timestamp of the last replayed request and uptime when it was replayed, received
+ * records are due after the same delay as they were captured. */
+static uint32_t prv_anchor_timestamp;
+static uint32_t prv_anchor_uptime;
+
+/* Line that is being transmitted has no content so far. */
+static bool prv_tx_empty = true;
+
+/* Line was transmitted and the end of its response was not received yet. */
+static bool prv_rx_wake_armed;
+
+/**
+ * @brief Get header of the current record.
+ *
+ * @return true on success, false if the whole session was replayed.
+ */
+static bool prv_hdr_get(struct notecard_capture_hdr *hdr)
+{
+	if (prv_pos + sizeof(*hdr) > prv_session_len) {
+		return false;
+	}
+
+	/* Records are not aligned in the session. */
+	memcpy(hdr, &prv_session[prv_pos], sizeof(*hdr));
+
+	return true;
+}
+
+static void prv_rec_next(const struct notecard_capture_hdr *hdr)
+{
+	prv_pos += sizeof(*hdr) + hdr->len;
+	prv_rec_pos = 0;
+}
+
+/**
+ * @brief Get time until the next received byte is due.
+ *
+ * @return Time in microseconds, 0 if byte is due already, -1 if nothing is received before the
+ * next request.
+ */
+static int64_t prv_rx_due_in(void)
+{
+	struct notecard_capture_hdr hdr;
+
+	while (prv_hdr_get(&hdr) && hdr.dir == NOTECARD_CAPTURE_RX) {
+		if (prv_rec_pos < hdr.len) {
+			uint32_t elapsed = notecard_capture_timestamp() - prv_anchor_uptime;
+			uint32_t offset = hdr.timestamp_us - prv_anchor_timestamp;
+
+			return offset > elapsed ? offset - elapsed : 0;
+		}
+
+		prv_rec_next(&hdr);
+	}
+
+	return -1;
+}
+
+/**
+ * @brief Receive bytes that are due.
+ *
+ * @return Number of received bytes.
+ */
+static size_t prv_rx(uint8_t *buf, size_t size)
+{
+	struct notecard_capture_hdr hdr;
+	size_t n = 0;
+
+	while (n < size && prv_rx_due_in() == 0) {
+		prv_hdr_get(&hdr);
+
+		size_t chunk = MIN(size - n, hdr.len - prv_rec_pos);
+
+		memcpy(&buf[n], &prv_session[prv_pos + sizeof(hdr) + prv_rec_pos], chunk);
+		prv_rec_pos += chunk;
+		n += chunk;
+	}
+
+	return n;
+}
+
+/**
+ * @brief Check if the byte is not a whitespace, i.e. the line that contains it is not empty.
+ */
+static bool prv_is_content(uint8_t c)
+{
+	return c != ' ' && c != '\r' && c != '\n' && c != '\t';
+}
+
+/**
+ * @brief Move to the response of the next captured request.
+ *
+ * Captured requests are skipped, together with their responses, until a request is found that is
+ * empty exactly when the transmitted one is, so empty lines (which note-c sends to reset the
+ * notecard) do not need to be captured and replayed in the same places.
+ */
+static void prv_tx_line(bool empty)
+{
+	struct notecard_capture_hdr hdr;
+	bool captured_empty = true;
+
+	while (prv_hdr_get(&hdr)) {
+		const uint8_t *payload = &prv_session[prv_pos + sizeof(hdr)];
+
+		prv_rec_next(&hdr);
+
+		if (hdr.dir != NOTECARD_CAPTURE_TX) {
+			continue;
+		}
+
+		for (size_t i = 0; i < hdr.len; i++) {
+			if (payload[i] != '\n') {
+				captured_empty = captured_empty && !prv_is_content(payload[i]);
+				continue;
+			}
+
+			if (captured_empty == empty) {
+				prv_anchor_timestamp = hdr.timestamp_us;
+				prv_anchor_uptime = notecard_capture_timestamp();
+				return;
+			}
+
+			captured_empty = true;
+		}
+	}
+
+	LOG_WRN("Replayed session has no more requests");
+}
+
+/**
+ * @brief Transmit bytes, replay moves to the next response once a line is complete.
+ */
+static void prv_tx(const uint8_t *buf, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		if (buf[i] == '\n') {
+			prv_tx_line(prv_tx_empty);
+			prv_tx_empty = true;
+			prv_rx_wake_armed = true;
+		} else if (prv_is_content(buf[i])) {
+			prv_tx_empty = false;
+		}
+	}
+}
+
+static bool prv_reset(void)
+{
+	return true;
+}
+
+static void prv_transmit(uint8_t *text_, size_t len_, bool flush_)
+{
+	ARG_UNUSED(flush_);
+
+	uint32_t start = notecard_stats_now();
+
+	prv_tx(text_, len_);
+	notecard_stats_tx(notecard_ctrl_owner(), len_, start, 0);
+}
+
+static bool prv_rx_available(void)
+{
+	return prv_rx_due_in() == 0;
+}
+
+static char prv_receive(void)
+{
+	uint8_t c;
+
+	if (prv_rx(&c, 1) == 0) {
+		return '\0';
+	}
+
+	if (c == '\n') {
+		prv_rx_wake_armed = false;
+	}
+
+	notecard_stats_rx(notecard_ctrl_owner(), 1, c == '\n', 0);
+
+	return (char)c;
+}
+
+int notecard_replay_load(const uint8_t *session, size_t len)
+{
+	struct notecard_capture_hdr hdr;
+
+	for (size_t pos = 0; pos < len; pos += sizeof(hdr) + hdr.len) {
+		if (pos + sizeof(hdr) > len) {
+			return -EINVAL;
+		}
+
+		memcpy(&hdr, &session[pos], sizeof(hdr));
+
+		if (hdr.dir > NOTECARD_CAPTURE_RX || pos + sizeof(hdr) + hdr.len > len) {
+			return -EINVAL;
+		}
+	}
+
+	prv_session = session;
+	prv_session_len = len;
+	prv_pos = 0;
+	prv_rec_pos = 0;
+	prv_tx_empty = true;
+	prv_rx_wake_armed = false;
+
+	/* Responses captured before the first request are due relative to the start of the
+	 * session. */
+	prv_anchor_timestamp = prv_hdr_get(&hdr) ? hdr.timestamp_us : 0;
+	prv_anchor_uptime = notecard_capture_timestamp();
+
+	return 0;
+}
+
+bool notecard_replay_done(void)
+{
+	struct notecard_capture_hdr hdr;
+
+	/* Skips records that were received already. */
+	prv_rx_due_in();
+
+	return !prv_hdr_get(&hdr);
+}
+
+int notecard_replay_init(const struct notecard_bus *bus)
+{
+	ARG_UNUSED(bus);
+
+	return 0;
+}
+
+void notecard_replay_attach_bus_api(const struct notecard_bus *bus)
+{
+	ARG_UNUSED(bus);
+
+	/* Session is replayed as a serial byte stream, regardless of the bus in the devicetree. */
+	NoteSetFnSerial(prv_reset, prv_transmit, prv_rx_available, prv_receive);
+}
+
+bool notecard_replay_is_present(const struct notecard_bus *bus, k_timeout_t timeout)
+{
+	ARG_UNUSED(bus);
+	ARG_UNUSED(timeout);
+
+	return prv_session != NULL;
+}
+
+int notecard_replay_write(const struct notecard_bus *bus, const uint8_t *buf, size_t len)
+{
+	ARG_UNUSED(bus);
+
+	prv_tx(buf, len);
+
+	return 0;
+}
+
+int notecard_replay_read(const struct notecard_bus *bus, uint8_t *buf, size_t size)
+{
+	ARG_UNUSED(bus);
+
+	return prv_rx(buf, size);
+}
+
+#if CONFIG_NOTECARD_RX_WAKE
+void notecard_replay_rx_wait(const struct notecard_bus *bus, k_timeout_t timeout)
+{
+	ARG_UNUSED(bus);
+
+	int64_t due_in = prv_rx_wake_armed ? prv_rx_due_in() : -1;
+
+	if (due_in < 0) {
+		k_sleep(timeout);
+		return;
+	}
+
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	k_timepoint_t due = sys_timepoint_calc(K_USEC(due_in));
+
+	k_sleep(sys_timepoint_timeout(sys_timepoint_cmp(due, end) < 0 ? due : end));
+}
+#endif
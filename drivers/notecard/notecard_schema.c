@@ -0,0 +1,229 @@
+/** @file notecard_schema.c
+ *
+ * @brief Notes of schemas defined at compile time, sent with their note.template.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* Values of the note.template body, which tell the notecard the type and size of each field.
+ * String fields are described with a string of their maximum length instead. */
+static const char *const prv_hints[] = {
+	[NOTECARD_FIELD_BOOL] = "true",
+	[NOTECARD_FIELD_INT8] = "11",
+	[NOTECARD_FIELD_UINT8] = "21",
+	[NOTECARD_FIELD_INT16] = "12",
+	[NOTECARD_FIELD_UINT16] = "22",
+	[NOTECARD_FIELD_INT32] = "14",
+	[NOTECARD_FIELD_UINT32] = "24",
+	[NOTECARD_FIELD_INT64] = "18",
+	[NOTECARD_FIELD_FLOAT] = "14.1",
+	[NOTECARD_FIELD_DOUBLE] = "18.1",
+};
+
+/**
+ * @brief Finish the request and check its response for an error.
+ */
+static int prv_end(struct notecard_writer *w)
+{
+	/* Only the start of the response is needed to tell if it is an error. */
+	char rsp[64];
+
+	int rc = notecard_writer_end(w, rsp, sizeof(rsp));
+	if (rc && rc != -EMSGSIZE) {
+		return rc;
+	}
+
+	if (strstr(rsp, "\"err\":")) {
+		LOG_ERR("Notecard responded with an error: %s", rsp);
+		return -EBADMSG;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write a string hint of the maximum length of the string field.
+ */
+static void prv_put_string_hint(struct notecard_writer *w, const struct notecard_field *field)
+{
+	static const char fill[] = "xxxxxxxxxxxxxxxx";
+	/* Last byte of the array holds the terminating null. */
+	size_t len = field->size - 1;
+
+	notecard_writer_put(w, "\"", 1);
+
+	while (len > 0) {
+		size_t n = MIN(len, sizeof(fill) - 1);
+
+		notecard_writer_put(w, fill, n);
+		len -= n;
+	}
+
+	notecard_writer_put(w, "\"", 1);
+}
+
+static int prv_template_register(const struct device *dev, const struct notecard_schema *schema)
+{
+	struct notecard_writer w;
+
+	notecard_writer_req_begin(&w, dev, "note.template");
+	notecard_writer_add_string(&w, "file", schema->file);
+	notecard_writer_object_begin(&w, "body");
+
+	for (size_t i = 0; i < schema->num_fields; i++) {
+		const struct notecard_field *field = &schema->fields[i];
+
+		notecard_writer_put_key(&w, field->name);
+
+		if (field->type == NOTECARD_FIELD_STRING) {
+			prv_put_string_hint(&w, field);
+		} else {
+			notecard_writer_put(&w, prv_hints[field->type], strlen(prv_hints[field->type]));
+		}
+	}
+
+	notecard_writer_object_end(&w);
+
+	return prv_end(&w);
+}
+
+/**
+ * @brief Register note.template of the schema, unless it was already registered.
+ *
+ * Caller needs to have the control of the notecard, it protects the list of registered schemas.
+ */
+static int prv_template_ensure(const struct device *dev, const struct notecard_schema *schema)
+{
+	struct notecard_data *data = dev->data;
+	struct notecard_schema_data *sd = &data->schema;
+
+	for (size_t i = 0; i < sd->count; i++) {
+		if (sd->registered[i] == schema) {
+			return 0;
+		}
+	}
+
+	int rc = prv_template_register(dev, schema);
+	if (rc) {
+		LOG_ERR("Failed to register template of %s (err=%d)", schema->file, rc);
+		return rc;
+	}
+
+	if (sd->count < ARRAY_SIZE(sd->registered)) {
+		sd->registered[sd->count++] = schema;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Write the field of the note, read from its member of the note struct.
+ */
+static void prv_field_write(struct notecard_writer *w, const struct notecard_field *field,
+			    const uint8_t *note)
+{
+	const void *member = &note[field->offset];
+
+	union {
+		bool b;
+		int8_t i8;
+		uint8_t u8;
+		int16_t i16;
+		uint16_t u16;
+		int32_t i32;
+		uint32_t u32;
+		int64_t i64;
+		float f;
+		double d;
+	} v;
+
+	if (field->type == NOTECARD_FIELD_STRING) {
+		notecard_writer_add_string(w, field->name, member);
+		return;
+	}
+
+	memcpy(&v, member, field->size);
+
+	switch (field->type) {
+	case NOTECARD_FIELD_BOOL:
+		notecard_writer_add_bool(w, field->name, v.b);
+		break;
+	case NOTECARD_FIELD_INT8:
+		notecard_writer_add_int(w, field->name, v.i8);
+		break;
+	case NOTECARD_FIELD_UINT8:
+		notecard_writer_add_int(w, field->name, v.u8);
+		break;
+	case NOTECARD_FIELD_INT16:
+		notecard_writer_add_int(w, field->name, v.i16);
+		break;
+	case NOTECARD_FIELD_UINT16:
+		notecard_writer_add_int(w, field->name, v.u16);
+		break;
+	case NOTECARD_FIELD_INT32:
+		notecard_writer_add_int(w, field->name, v.i32);
+		break;
+	case NOTECARD_FIELD_UINT32:
+		notecard_writer_add_int(w, field->name, v.u32);
+		break;
+	case NOTECARD_FIELD_INT64:
+		notecard_writer_add_int(w, field->name, v.i64);
+		break;
+	case NOTECARD_FIELD_FLOAT:
+		notecard_writer_add_number(w, field->name, v.f);
+		break;
+	case NOTECARD_FIELD_DOUBLE:
+		notecard_writer_add_number(w, field->name, v.d);
+		break;
+	default:
+		break;
+	}
+}
+
+int notecard_note_add(const struct device *dev, const struct notecard_schema *schema,
+		      const void *note)
+{
+	const uint8_t *base = note;
+
+	/* Strings are checked before anything is sent, a request can not be aborted halfway. */
+	for (size_t i = 0; i < schema->num_fields; i++) {
+		const struct notecard_field *field = &schema->fields[i];
+
+		if (field->type == NOTECARD_FIELD_STRING &&
+		    !memchr(&base[field->offset], '\0', field->size)) {
+			LOG_ERR("Field %s of %s is not null-terminated", field->name, schema->file);
+			return -EINVAL;
+		}
+	}
+
+	int rc = prv_template_ensure(dev, schema);
+	if (rc) {
+		return rc;
+	}
+
+	struct notecard_writer w;
+
+	notecard_writer_req_begin(&w, dev, "note.add");
+	notecard_writer_add_string(&w, "file", schema->file);
+	notecard_writer_object_begin(&w, "body");
+
+	for (size_t i = 0; i < schema->num_fields; i++) {
+		prv_field_write(&w, &schema->fields[i], base);
+	}
+
+	notecard_writer_object_end(&w);
+
+	return prv_end(&w);
+}
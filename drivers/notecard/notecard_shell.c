@@ -0,0 +1,206 @@
+/** @file notecard_shell.c
+ *
+ * @brief Shell commands of the notecard driver.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/device.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/printk.h>
+
+#include <string.h>
+
+#if CONFIG_NOTECARD_STATS
+#define NOTECARD_DEVICE_GET(inst) DEVICE_DT_INST_GET(inst),
+
+static const struct device *const prv_devs[] = {DT_INST_FOREACH_STATUS_OKAY(NOTECARD_DEVICE_GET)};
+
+/**
+ * @brief Get notecard instance with the given name.
+ *
+ * @return Device struct of notecard driver instance or NULL if there is no such instance.
+ */
+static const struct device *prv_dev_get(const char *name)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(prv_devs); i++) {
+		if (strcmp(prv_devs[i]->name, name) == 0) {
+			return prv_devs[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void prv_dev_name_get(size_t idx, struct shell_static_entry *entry)
+{
+	entry->syntax = idx < ARRAY_SIZE(prv_devs) ? prv_devs[idx]->name : NULL;
+	entry->handler = NULL;
+	entry->help = NULL;
+	entry->subcmd = NULL;
+}
+
+SHELL_DYNAMIC_CMD_CREATE(dsub_notecard_dev, prv_dev_name_get);
+
+static void prv_hist_print(const struct shell *sh, const char *name,
+			   const struct notecard_latency_hist *hist)
+{
+	if (hist->count == 0) {
+		shell_print(sh, "  %-9s count 0", name);
+		return;
+	}
+
+	shell_print(sh, "  %-9s count %u, avg %u us, max %u us", name, hist->count,
+		    (uint32_t)(hist->total_us / hist->count), hist->max_us);
+
+	for (size_t i = 0; i < NOTECARD_STATS_BUCKETS; i++) {
+		if (hist->buckets[i] == 0) {
+			continue;
+		}
+
+		/* Buckets are labeled with their upper bound, see struct notecard_latency_hist. */
+		if (i == NOTECARD_STATS_BUCKETS - 1) {
+			shell_print(sh, "    >= %8u us: %u", 1U << (i + 4), hist->buckets[i]);
+		} else {
+			shell_print(sh, "    <  %8u us: %u", 1U << (i + 5), hist->buckets[i]);
+		}
+	}
+}
+
+static void prv_stats_print(const struct shell *sh, const struct device *dev)
+{
+	struct notecard_stats stats;
+
+	notecard_stats_get(dev, &stats);
+
+	shell_print(sh, "%s:", dev->name);
+	shell_print(sh, "  tx %u bytes, %u errors", stats.tx_bytes, stats.tx_errors);
+	shell_print(sh, "  rx %u bytes, %u errors", stats.rx_bytes, stats.rx_errors);
+	shell_print(sh, "  control timeouts %u", stats.ctrl_timeouts);
+	prv_hist_print(sh, "lock wait", &stats.lock_wait);
+	prv_hist_print(sh, "lock hold", &stats.lock_hold);
+	prv_hist_print(sh, "tx", &stats.tx);
+	prv_hist_print(sh, "rx wait", &stats.rx_wait);
+	prv_hist_print(sh, "parse", &stats.parse);
+}
+
+/**
+ * @brief Call the handler for the instance given in the arguments, or for all instances.
+ */
+static int prv_for_each_dev(const struct shell *sh, size_t argc, char **argv,
+			    void (*handler)(const struct shell *sh, const struct device *dev))
+{
+	if (argc > 1) {
+		const struct device *dev = prv_dev_get(argv[1]);
+
+		if (!dev) {
+			shell_error(sh, "Unknown notecard: %s", argv[1]);
+			return -ENODEV;
+		}
+
+		handler(sh, dev);
+		return 0;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(prv_devs); i++) {
+		handler(sh, prv_devs[i]);
+	}
+
+	return 0;
+}
+
+static void prv_stats_reset(const struct shell *sh, const struct device *dev)
+{
+	notecard_stats_reset(dev);
+	shell_print(sh, "%s: statistics cleared", dev->name);
+}
+
+static int cmd_stats_show(const struct shell *sh, size_t argc, char **argv)
+{
+	return prv_for_each_dev(sh, argc, argv, prv_stats_print);
+}
+
+static int cmd_stats_reset(const struct shell *sh, size_t argc, char **argv)
+{
+	return prv_for_each_dev(sh, argc, argv, prv_stats_reset);
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_notecard_stats,
+			       SHELL_CMD_ARG(show, &dsub_notecard_dev,
+					     "Show latency histograms and bus counters [device]",
+					     cmd_stats_show, 1, 1),
+			       SHELL_CMD_ARG(reset, &dsub_notecard_dev, "Clear statistics [device]",
+					     cmd_stats_reset, 1, 1),
+			       SHELL_SUBCMD_SET_END);
+
+#define NOTECARD_SHELL_STATS_CMD SHELL_CMD(stats, &sub_notecard_stats, "Driver statistics", NULL),
+#else
+#define NOTECARD_SHELL_STATS_CMD
+#endif /* CONFIG_NOTECARD_STATS */
+
+#if CONFIG_NOTECARD_CAPTURE
+static int cmd_capture_dump(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	uint8_t buf[sizeof(struct notecard_capture_hdr) + NOTECARD_CAPTURE_RECORD_MAX_LEN];
+	size_t total = 0;
+	size_t len;
+
+	shell_print(sh, "/* %u records dropped */", notecard_capture_dropped());
+
+	/* Session is printed as a C array initializer, ready to be given to
+	 * notecard_replay_load(). */
+	while ((len = notecard_capture_get(buf, sizeof(buf))) > 0) {
+		for (size_t i = 0; i < len; i += 16) {
+			char line[16 * 6 + 1];
+			size_t pos = 0;
+
+			for (size_t j = i; j < MIN(len, i + 16); j++) {
+				pos += snprintk(&line[pos], sizeof(line) - pos, "0x%02x, ", buf[j]);
+			}
+
+			shell_print(sh, "%s", line);
+		}
+
+		total += len;
+	}
+
+	shell_print(sh, "/* %zu bytes */", total);
+
+	return 0;
+}
+
+static int cmd_capture_clear(const struct shell *sh, size_t argc, char **argv)
+{
+	ARG_UNUSED(argc);
+	ARG_UNUSED(argv);
+
+	notecard_capture_clear();
+	shell_print(sh, "Capture cleared");
+
+	return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_notecard_capture,
+			       SHELL_CMD(dump, NULL, "Print and remove captured session",
+					 cmd_capture_dump),
+			       SHELL_CMD(clear, NULL, "Drop captured session", cmd_capture_clear),
+			       SHELL_SUBCMD_SET_END);
+
+#define NOTECARD_SHELL_CAPTURE_CMD                                                                 \
+	SHELL_CMD(capture, &sub_notecard_capture, "Bus transaction capture", NULL),
+#else
+#define NOTECARD_SHELL_CAPTURE_CMD
+#endif /* CONFIG_NOTECARD_CAPTURE */
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_notecard, NOTECARD_SHELL_STATS_CMD NOTECARD_SHELL_CAPTURE_CMD
+						     SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(notecard, &sub_notecard, "Notecard commands", NULL);
@@ -0,0 +1,171 @@
+/** @file notecard_stats.c
+ *
+ * @brief Latency histograms and bus counters.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+
+#include <string.h>
+
+/* Durations shorter than 2^STATS_BUCKET_0_SHIFT us all land in the first bucket. */
+#define STATS_BUCKET_0_SHIFT 5
+
+/**
+ * @brief Get histogram of the given latency.
+ */
+static struct notecard_latency_hist *prv_hist_get(struct notecard_stats *stats,
+						  enum notecard_stats_latency id)
+{
+	switch (id) {
+	case NOTECARD_STATS_LOCK_WAIT:
+		return &stats->lock_wait;
+	case NOTECARD_STATS_LOCK_HOLD:
+		return &stats->lock_hold;
+	case NOTECARD_STATS_TX:
+		return &stats->tx;
+	case NOTECARD_STATS_RX_WAIT:
+		return &stats->rx_wait;
+	case NOTECARD_STATS_PARSE:
+	default:
+		return &stats->parse;
+	}
+}
+
+/**
+ * @brief Add duration to the histogram, caller needs to hold the stats lock.
+ */
+static void prv_hist_add(struct notecard_latency_hist *hist, uint32_t cycles)
+{
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+	uint32_t idx = 0;
+
+	if (us >> STATS_BUCKET_0_SHIFT) {
+		/* One-based position of the highest set bit, i.e. floor(log2(us)) + 1. */
+		idx = find_msb_set(us) - STATS_BUCKET_0_SHIFT;
+	}
+
+	hist->buckets[MIN(idx, NOTECARD_STATS_BUCKETS - 1)]++;
+	hist->count++;
+	hist->max_us = MAX(hist->max_us, us);
+	hist->total_us += us;
+}
+
+void notecard_stats_latency(const struct device *dev, enum notecard_stats_latency id,
+			    uint32_t start)
+{
+	if (!dev) {
+		return;
+	}
+
+	/* Unsigned subtraction also handles the wrap around of the cycle counter. */
+	uint32_t cycles = k_cycle_get_32() - start;
+	struct notecard_data *data = dev->data;
+
+	K_SPINLOCK(&data->stats.lock) {
+		prv_hist_add(prv_hist_get(&data->stats.stats, id), cycles);
+	}
+}
+
+void notecard_stats_tx(const struct device *dev, size_t len, uint32_t start, int err)
+{
+	if (!dev) {
+		return;
+	}
+
+	uint32_t now = k_cycle_get_32();
+	struct notecard_data *data = dev->data;
+	struct notecard_stats_data *s = &data->stats;
+
+	K_SPINLOCK(&s->lock) {
+		if (err) {
+			s->stats.tx_errors++;
+		} else {
+			prv_hist_add(&s->stats.tx, now - start);
+			s->stats.tx_bytes += len;
+			s->rx_wait_start = now;
+			s->rx_wait_pending = true;
+		}
+	}
+}
+
+void notecard_stats_rx(const struct device *dev, size_t len, bool eol, int err)
+{
+	if (!dev) {
+		return;
+	}
+
+	uint32_t now = k_cycle_get_32();
+	struct notecard_data *data = dev->data;
+	struct notecard_stats_data *s = &data->stats;
+
+	K_SPINLOCK(&s->lock) {
+		if (err) {
+			s->stats.rx_errors++;
+		} else {
+			s->stats.rx_bytes += len;
+
+			if (eol && s->rx_wait_pending) {
+				prv_hist_add(&s->stats.rx_wait, now - s->rx_wait_start);
+				s->rx_wait_pending = false;
+			}
+		}
+	}
+}
+
+void notecard_stats_ctrl_timeout(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+
+	K_SPINLOCK(&data->stats.lock) {
+		data->stats.stats.ctrl_timeouts++;
+	}
+}
+
+void notecard_stats_get(const struct device *dev, struct notecard_stats *stats)
+{
+	struct notecard_data *data = dev->data;
+
+	K_SPINLOCK(&data->stats.lock) {
+		*stats = data->stats.stats;
+	}
+}
+
+void notecard_stats_reset(const struct device *dev)
+{
+	struct notecard_data *data = dev->data;
+
+	K_SPINLOCK(&data->stats.lock) {
+		memset(&data->stats.stats, 0, sizeof(data->stats.stats));
+		data->stats.rx_wait_pending = false;
+	}
+}
+
+uint32_t notecard_latency_hist_percentile(const struct notecard_latency_hist *hist,
+					  unsigned int percent)
+{
+	if (hist->count == 0) {
+		return 0;
+	}
+
+	/* Rank of the duration at the given percentile, rounded up so 100 % is the last one. */
+	uint64_t rank = DIV_ROUND_UP((uint64_t)hist->count * MIN(percent, 100U), 100U);
+	uint64_t seen = 0;
+
+	for (size_t i = 0; i < NOTECARD_STATS_BUCKETS - 1; i++) {
+		seen += hist->buckets[i];
+
+		if (seen >= MAX(rank, 1U)) {
+			return MIN(1U << (i + STATS_BUCKET_0_SHIFT), hist->max_us);
+		}
+	}
+
+	/* Last bucket has no upper bound. */
+	return hist->max_us;
+}
@@ -0,0 +1,258 @@
+/** @file notecard_transport.c
+ *
+ * @brief Raw transmissions to the notecard, which bypass note-c.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/__assert.h>
+
+#include <note.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+void notecard_transport_init(struct notecard_transport *tp, const struct device *dev)
+{
+	const struct notecard_config *config = dev->config;
+
+	__ASSERT(notecard_ctrl_owner() == dev, "Control of the notecard needs to be taken");
+
+	tp->dev = dev;
+	tp->bus = &config->bus;
+	tp->segment_len = 0;
+
+	notecard_transport_rx_flush(tp);
+}
+
+void notecard_transport_rx_flush(struct notecard_transport *tp)
+{
+	uint8_t scratch[16];
+	size_t dropped = 0;
+	int rc;
+
+	/* Leftovers of an abandoned transaction are not bus traffic of the next request, so they
+	 * are neither counted nor captured. */
+	while ((rc = tp->bus->read(tp->bus, scratch, sizeof(scratch))) > 0) {
+		dropped += rc;
+	}
+
+	if (dropped > 0) {
+		LOG_WRN("Dropped %zu stale received bytes", dropped);
+	}
+}
+
+/**
+ * @brief Wait until the notecard can receive the next chunk.
+ */
+static void prv_chunk_wait(struct notecard_transport *tp)
+{
+	struct notecard_data *data = tp->dev->data;
+
+	if (tp->bus->chunk_delay_ms > 0) {
+		k_sleep(sys_timepoint_timeout(data->tx_chunk_next));
+	}
+}
+
+/**
+ * @brief Start the chunk delay, after a chunk was transmitted.
+ */
+static void prv_chunk_sent(struct notecard_transport *tp)
+{
+	struct notecard_data *data = tp->dev->data;
+
+	if (tp->bus->chunk_delay_ms > 0) {
+		data->tx_chunk_next = sys_timepoint_calc(K_MSEC(tp->bus->chunk_delay_ms));
+	}
+}
+
+int notecard_transport_write(struct notecard_transport *tp, const void *buf, size_t len)
+{
+	const uint8_t *ptr = buf;
+
+	while (len > 0) {
+		if (tp->segment_len == NOTECARD_SEGMENT_MAX_LEN) {
+			/* Give the notecard time to process the segment. */
+			k_msleep(NOTECARD_SEGMENT_DELAY_MS);
+			tp->segment_len = 0;
+		}
+
+		size_t n = MIN(len, NOTECARD_SEGMENT_MAX_LEN - tp->segment_len);
+
+		n = MIN(n, tp->bus->chunk_max_len);
+
+		prv_chunk_wait(tp);
+
+		uint32_t start = notecard_stats_now();
+
+		int rc = tp->bus->write(tp->bus, ptr, n);
+
+		prv_chunk_sent(tp);
+
+		notecard_stats_tx(tp->dev, n, start, rc);
+		if (rc) {
+			return rc;
+		}
+
+		notecard_capture_tx(ptr, n);
+
+		ptr += n;
+		len -= n;
+		tp->segment_len += n;
+	}
+
+	return 0;
+}
+
+int notecard_transport_write_json(struct notecard_transport *tp, J *req)
+{
+	char *json = JPrintUnformatted(req);
+	JDelete(req);
+
+	if (!json) {
+		return -ENOMEM;
+	}
+
+	int rc = notecard_transport_write(tp, json, strlen(json));
+	if (!rc) {
+		rc = notecard_transport_write(tp, "\n", 1);
+	}
+
+	JFree(json);
+
+	if (rc) {
+		LOG_ERR("Failed to send request (err=%d)", rc);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+int notecard_transport_read(struct notecard_transport *tp, uint8_t *buf, size_t size)
+{
+	int rc = tp->bus->read(tp->bus, buf, size);
+
+	notecard_stats_rx(tp->dev, rc > 0 ? rc : 0, rc > 0 && memchr(buf, '\n', rc), rc < 0 ? rc : 0);
+	if (rc > 0) {
+		notecard_capture_rx(buf, rc);
+	}
+
+	return rc;
+}
+
+int notecard_transport_read_line(struct notecard_transport *tp, char *buf, size_t size,
+				 k_timeout_t timeout)
+{
+	__ASSERT(size > 0, "Buffer needs to fit at least the null terminator");
+
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	size_t len = 0;
+	bool overflow = false;
+
+	while (true) {
+		uint8_t scratch[16];
+		/* Once the buffer is full, rest of the line is drained into the scratch buffer. */
+		uint8_t *dst = overflow ? scratch : (uint8_t *)buf + len;
+		size_t space = overflow ? sizeof(scratch) : size - 1 - len;
+
+		int rc = notecard_transport_read(tp, dst, space);
+		if (rc < 0) {
+			return rc;
+		}
+
+		char *newline = memchr(dst, '\n', rc);
+
+		if (!overflow) {
+			len += newline ? (size_t)(newline - (char *)dst) : (size_t)rc;
+		}
+
+		if (newline) {
+			break;
+		}
+
+		if (!overflow && len == size - 1) {
+			overflow = true;
+		}
+
+		if (rc == 0) {
+			if (sys_timepoint_expired(end)) {
+				return -ETIMEDOUT;
+			}
+			k_msleep(NOTECARD_RX_POLL_MS);
+		}
+	}
+
+	if (len > 0 && buf[len - 1] == '\r') {
+		len--;
+	}
+	buf[len] = '\0';
+
+	return overflow ? -EMSGSIZE : (int)len;
+}
+
+int notecard_cmd(const struct device *dev, J *cmd)
+{
+	__ASSERT(cmd, "Command needs to be provided");
+
+	/* NoteNewRequest() names the request with "req" key, notecard responds only to those. */
+	J *name = JGetObjectItem(cmd, "req");
+	if (name) {
+		if (!JAddStringToObject(cmd, "cmd", name->valuestring)) {
+			JDelete(cmd);
+			return -ENOMEM;
+		}
+		JDeleteItemFromObject(cmd, "req");
+	}
+
+	struct notecard_transport tp;
+
+	notecard_transport_init(&tp, dev);
+
+	return notecard_transport_write_json(&tp, cmd);
+}
+
+int notecard_request_static(const struct device *dev, const struct notecard_static_request *req,
+			    char *rsp, size_t rsp_size)
+{
+	struct notecard_transport tp;
+
+	notecard_transport_init(&tp, dev);
+
+	int rc = notecard_transport_write(&tp, req->json, req->len);
+	if (rc) {
+		LOG_ERR("Failed to send static request (err=%d)", rc);
+		return rc;
+	}
+
+	if (req->is_cmd) {
+		return 0;
+	}
+
+	/* Response still needs to be read, even if the caller does not need it. */
+	char scratch[32];
+	bool keep_rsp = rsp != NULL;
+
+	if (!keep_rsp) {
+		rsp = scratch;
+		rsp_size = sizeof(scratch);
+	}
+
+	rc = notecard_transport_read_line(&tp, rsp, rsp_size, K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+	if (rc == -EMSGSIZE && !keep_rsp) {
+		return 0;
+	}
+	if (rc < 0) {
+		LOG_ERR("Failed to read response (err=%d)", rc);
+		return rc;
+	}
+
+	return 0;
+}
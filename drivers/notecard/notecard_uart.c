@@ -17,16 +17,270 @@
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
-
-#define SERIAL_PEEK_EMPTY_MASK 0xFF00
-
-static uint16_t prv_peek_buf = SERIAL_PEEK_EMPTY_MASK;
+#include <string.h>
 
 /* Local pointer to the uart device that is currently used for communication  */
 static const struct device *prv_uart_dev;
 
 LOG_MODULE_REGISTER(notecard_uart);
 
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+
+/* Local pointer to the data of the uart bus that is currently used for communication */
+static struct notecard_uart_data *prv_uart_data;
+
+/**
+ * @brief Move all received bytes from the uart fifo into the ring buffer.
+ *
+ * Bytes that do not fit into the ring buffer are still read out of the fifo (otherwise the isr
+ * would keep firing), but are dropped and counted.
+ */
+static void prv_isr_rx(const struct device *dev, struct notecard_uart_data *data)
+{
+	int err = uart_err_check(dev);
+
+	if (err > 0 && (err & UART_ERROR_OVERRUN)) {
+		data->rx_hw_overruns++;
+	}
+
+	while (true) {
+		uint8_t *buf;
+		uint32_t space = ring_buf_put_claim(&data->rx_ring, &buf, UINT32_MAX);
+
+		if (space == 0) {
+			uint8_t dummy;
+
+			while (uart_fifo_read(dev, &dummy, 1) == 1) {
+				data->rx_dropped++;
+			}
+			break;
+		}
+
+		int rd = uart_fifo_read(dev, buf, space);
+
+		ring_buf_put_finish(&data->rx_ring, rd > 0 ? rd : 0);
+
+		if (rd <= 0) {
+			break;
+		}
+
+		data->rx_received += rd;
+		k_sem_give(&data->rx_sem);
+
+		if ((uint32_t)rd < space) {
+			/* Fifo is empty, otherwise claim wraps around the end of the ring buffer. */
+			break;
+		}
+	}
+}
+
+static void prv_isr_tx(const struct device *dev, struct notecard_uart_data *data)
+{
+	k_spinlock_key_t key = k_spin_lock(&data->tx_lock);
+
+	if (!data->tx_active) {
+		/* Transmission timed out and was abandoned by the thread. */
+		uart_irq_tx_disable(dev);
+		goto unlock;
+	}
+
+	if (data->tx_len == 0) {
+		/* Fifo being ready only means that it can be filled again, the last bytes may still
+		 * be shifting out. Drivers that can not tell return -ENOSYS. */
+		if (uart_irq_tx_complete(dev) == 0) {
+			goto unlock;
+		}
+
+		uart_irq_tx_disable(dev);
+		data->tx_active = false;
+		k_sem_give(&data->tx_done);
+		goto unlock;
+	}
+
+	int sent = uart_fifo_fill(dev, data->tx_buf, data->tx_len);
+
+	if (sent > 0) {
+		data->tx_buf += sent;
+		data->tx_len -= sent;
+	}
+
+unlock:
+	k_spin_unlock(&data->tx_lock, key);
+}
+
+static void prv_uart_isr(const struct device *dev, void *user_data)
+{
+	struct notecard_uart_data *data = user_data;
+
+	if (!uart_irq_update(dev)) {
+		return;
+	}
+
+	if (uart_irq_rx_ready(dev)) {
+		prv_isr_rx(dev, data);
+	}
+
+	if (data->tx_active && uart_irq_tx_ready(dev)) {
+		prv_isr_tx(dev, data);
+	}
+}
+
+static bool prv_rx_available(void)
+{
+	return !ring_buf_is_empty(&prv_uart_data->rx_ring);
+}
+
+static char prv_receive(void)
+{
+	uint8_t c;
+
+	if (!ring_buf_get(&prv_uart_data->rx_ring, &c, 1)) {
+		return '\0';
+	}
+
+	if (c == '\n') {
+		/* Response is complete, further delays are not polls for it. */
+		prv_uart_data->rx_wake_armed = false;
+	}
+
+	notecard_stats_rx(notecard_ctrl_owner(), 1, c == '\n', 0);
+	notecard_capture_rx(&c, 1);
+
+	return (char)c;
+}
+
+/**
+ * @brief Drop everything that was received so far.
+ */
+static void prv_rx_flush(const struct device *uart, struct notecard_uart_data *data)
+{
+	/* Ring buffer can not be reset while the isr is writing into it. */
+	uart_irq_rx_disable(uart);
+	ring_buf_reset(&data->rx_ring);
+	k_sem_reset(&data->rx_sem);
+	data->rx_wake_armed = false;
+	uart_irq_rx_enable(uart);
+}
+
+static bool prv_reset(void)
+{
+	prv_rx_flush(prv_uart_dev, prv_uart_data);
+
+	return true;
+}
+
+/**
+ * @brief Transmit buffer through the uart isr.
+ *
+ * Calling thread sleeps until the isr fed the whole buffer to the uart and the uart sent it out.
+ *
+ * @return 0 on success, -ETIMEDOUT if the buffer was not sent out in time.
+ */
+static int prv_write(const struct device *uart, struct notecard_uart_data *data,
+		     const uint8_t *buf, size_t len)
+{
+	if (len == 0) {
+		return 0;
+	}
+
+	k_sem_reset(&data->tx_done);
+	/* Anything that signals reception from now on belongs to the response of this
+	 * transmission. */
+	k_sem_reset(&data->rx_sem);
+	data->rx_wake_armed = true;
+
+	k_spinlock_key_t key = k_spin_lock(&data->tx_lock);
+
+	data->tx_buf = buf;
+	data->tx_len = len;
+	data->tx_active = true;
+	k_spin_unlock(&data->tx_lock, key);
+
+	/* Isr fills the fifo from now on, we just sleep until it is done. */
+	uart_irq_tx_enable(uart);
+
+	if (k_sem_take(&data->tx_done, K_MSEC(CONFIG_NOTECARD_UART_TX_TIMEOUT_MS))) {
+		uart_irq_tx_disable(uart);
+
+		/* Isr may be running on another cpu, or was already entered, so the buffer is
+		 * released under the lock. */
+		key = k_spin_lock(&data->tx_lock);
+
+		size_t not_sent = data->tx_len;
+
+		data->tx_active = false;
+		data->tx_buf = NULL;
+		data->tx_len = 0;
+		k_spin_unlock(&data->tx_lock, key);
+
+		LOG_ERR("Transmit timed out, %zu bytes were not sent", not_sent);
+		return -ETIMEDOUT;
+	}
+
+	return 0;
+}
+
+static void prv_transmit(uint8_t *text_, size_t len_, bool flush_)
+{
+	ARG_UNUSED(flush_); /* We wait until the buffer is sent out (i.e. always flushes) */
+
+	uint32_t start = notecard_stats_now();
+	int rc = prv_write(prv_uart_dev, prv_uart_data, text_, len_);
+
+	notecard_stats_tx(notecard_ctrl_owner(), len_, start, rc);
+	if (rc == 0) {
+		notecard_capture_tx(text_, len_);
+	}
+}
+
+#if CONFIG_NOTECARD_RX_WAKE
+void notecard_uart_rx_wait(const struct notecard_bus *bus, k_timeout_t timeout)
+{
+	struct notecard_uart_data *data = bus->data;
+
+	if (!data->rx_wake_armed) {
+		/* Not waiting for a response (e.g. draining after a reset or an application
+		 * delay), so received bytes must not cut the delay short. */
+		k_sleep(timeout);
+		return;
+	}
+
+	k_sem_take(&data->rx_sem, timeout);
+}
+#endif
+
+int notecard_uart_init(const struct notecard_bus *bus)
+{
+	const struct device *uart = bus->dev.uart;
+	struct notecard_uart_data *data = bus->data;
+
+	if (!device_is_ready(uart)) {
+		LOG_ERR("uart device is not ready");
+		return -ENODEV;
+	}
+
+	ring_buf_init(&data->rx_ring, sizeof(data->rx_ring_buf), data->rx_ring_buf);
+	k_sem_init(&data->tx_done, 0, 1);
+	k_sem_init(&data->rx_sem, 0, 1);
+
+	int rc = uart_irq_callback_user_data_set(uart, prv_uart_isr, data);
+	if (rc) {
+		LOG_ERR("Failed to set uart isr (err=%d)", rc);
+		return rc;
+	}
+
+	/* From now on, everything that Notecard sends is captured by the isr. */
+	uart_irq_rx_enable(uart);
+
+	return 0;
+}
+
+#else
+
+#define SERIAL_PEEK_EMPTY_MASK 0xFF00
+
+static uint16_t prv_peek_buf = SERIAL_PEEK_EMPTY_MASK;
+
 static bool prv_rx_available(void)
 {
 	bool result;
@@ -60,38 +314,190 @@ static char prv_receive(void)
 		result = prv_peek_buf;
 		prv_peek_buf = SERIAL_PEEK_EMPTY_MASK;
 	} else if (uart_poll_in(prv_uart_dev, (unsigned char *)&result)) {
-		result = '\0';
+		return '\0';
 	}
 
+	notecard_stats_rx(notecard_ctrl_owner(), 1, result == '\n', 0);
+	notecard_capture_rx((const uint8_t *)&result, 1);
+
 	return result;
 }
 
-static bool prv_reset(void)
+/**
+ * @brief Drop everything that was received so far.
+ */
+static void prv_rx_flush(const struct device *uart, struct notecard_uart_data *data)
 {
-	char c;
+	ARG_UNUSED(data);
+	unsigned char c;
 
-	while (!uart_poll_in(prv_uart_dev, &c)) {
+	while (!uart_poll_in(uart, &c)) {
 	}
+}
+
+static bool prv_reset(void)
+{
+	prv_peek_buf = SERIAL_PEEK_EMPTY_MASK;
+	prv_rx_flush(prv_uart_dev, NULL);
 
 	return true;
 }
 
-static void prv_transmit(uint8_t *text_, size_t len_, bool flush_)
+/**
+ * @brief Transmit buffer with uart_poll_out.
+ *
+ * @return Always 0, `uart_poll_out` can not fail.
+ */
+static int prv_write(const struct device *uart, struct notecard_uart_data *data,
+		     const uint8_t *buf, size_t len)
 {
-	ARG_UNUSED(flush_); /* `uart_poll_out` blocks (i.e. always flushes) */
+	ARG_UNUSED(data);
 
-	for (size_t i = 0; i < len_; ++i) {
-		uart_poll_out(prv_uart_dev, text_[i]);
+	for (size_t i = 0; i < len; ++i) {
+		uart_poll_out(uart, buf[i]);
 		/* 100 us delay is needed to prevent overwhelming the nrfx implementation of
 		 * uart_poll_out and entering 1ms sleep between each call. */
 		k_busy_wait(100);
 	}
+
+	return 0;
+}
+
+static void prv_transmit(uint8_t *text_, size_t len_, bool flush_)
+{
+	ARG_UNUSED(flush_); /* `uart_poll_out` blocks (i.e. always flushes) */
+
+	uint32_t start = notecard_stats_now();
+
+	prv_write(prv_uart_dev, NULL, text_, len_);
+	notecard_stats_tx(notecard_ctrl_owner(), len_, start, 0);
+	notecard_capture_tx(text_, len_);
+}
+
+int notecard_uart_init(const struct notecard_bus *bus)
+{
+	if (!device_is_ready(bus->dev.uart)) {
+		LOG_ERR("uart device is not ready");
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN */
+
+/**
+ * @brief Read a single received character.
+ *
+ * @return 0 on success, -1 if nothing was received.
+ */
+static int prv_rx_char(const struct device *uart, struct notecard_uart_data *data, char *c)
+{
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+	ARG_UNUSED(uart);
+
+	return ring_buf_get(&data->rx_ring, (uint8_t *)c, 1) ? 0 : -1;
+#else
+	ARG_UNUSED(data);
+
+	return uart_poll_in(uart, (unsigned char *)c);
+#endif
+}
+
+/**
+ * @brief Wait for a single received character.
+ *
+ * @return 0 on success, -ETIMEDOUT if nothing was received in time.
+ */
+static int prv_rx_char_wait(const struct device *uart, struct notecard_uart_data *data, char *c,
+			    k_timepoint_t end)
+{
+	while (prv_rx_char(uart, data, c)) {
+		if (sys_timepoint_expired(end)) {
+			return -ETIMEDOUT;
+		}
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+		/* Isr gives the semaphore as soon as something is received. */
+		k_sem_take(&data->rx_sem, sys_timepoint_timeout(end));
+#else
+		k_msleep(1);
+#endif
+	}
+
+	return 0;
+}
+
+bool notecard_uart_is_present(const struct notecard_bus *bus, k_timeout_t timeout)
+{
+	const struct device *uart = bus->dev.uart;
+	struct notecard_uart_data *data = bus->data;
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	bool present = false;
+	char prev = '\0';
+	char c;
+
+	/* Clean up any characters left in the uart buffer. */
+	prv_rx_flush(uart, data);
+
+	if (prv_write(uart, data, (const uint8_t *)"\r\n", 2)) {
+		return false;
+	}
+
+	/* Notecard should respond with the same two characters back, return as soon as they
+	 * arrive. */
+	while (prv_rx_char_wait(uart, data, &c, end) == 0) {
+		if (prev == '\r' && c == '\n') {
+			present = true;
+			break;
+		}
+		prev = c;
+	}
+
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+	/* Echo is not read through prv_receive(), so the response wait armed by prv_write() ends
+	 * here. */
+	data->rx_wake_armed = false;
+#endif
+
+	return present;
+}
+
+int notecard_uart_write(const struct notecard_bus *bus, const uint8_t *buf, size_t len)
+{
+	return prv_write(bus->dev.uart, bus->data, buf, len);
+}
+
+int notecard_uart_read(const struct notecard_bus *bus, uint8_t *buf, size_t size)
+{
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+	struct notecard_uart_data *data = bus->data;
+	uint32_t n = ring_buf_get(&data->rx_ring, buf, size);
+
+	if (memchr(buf, '\n', n)) {
+		/* Response read by the driver's own API is complete. */
+		data->rx_wake_armed = false;
+	}
+
+	return n;
+#else
+	size_t n = 0;
+
+	while (n < size && prv_rx_char(bus->dev.uart, NULL, (char *)&buf[n]) == 0) {
+		n++;
+	}
+
+	return n;
+#endif
 }
 
 void notecard_uart_attach_bus_api(const struct notecard_bus *bus)
 {
 	prv_uart_dev = bus->dev.uart;
 
+#if CONFIG_NOTECARD_UART_INTERRUPT_DRIVEN
+	prv_uart_data = bus->data;
+#endif
+
 	/* Give note-c uart hooks. */
 	NoteSetFnSerial(prv_reset, prv_transmit, prv_rx_available, prv_receive);
 }
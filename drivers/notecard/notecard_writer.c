@@ -0,0 +1,345 @@
+/** @file notecard_writer.c
+ *
+ * @brief Streaming request serializer, which writes JSON directly to the notecard.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/__assert.h>
+
+#include <note.h>
+
+#include <string.h>
+
+LOG_MODULE_DECLARE(notecard, CONFIG_NOTECARD_LOG_LEVEL);
+
+/* Maximum nesting of objects, limited by the has_fields bitmask. */
+#define WRITER_MAX_DEPTH 31
+
+/**
+ * @brief Transmit buffered bytes to the notecard.
+ */
+static void prv_flush(struct notecard_writer *w)
+{
+	if (w->err || w->buf_len == 0) {
+		return;
+	}
+
+	const struct notecard_config *config = w->dev->config;
+	struct notecard_transport tp = {
+		.dev = w->dev,
+		.bus = &config->bus,
+		.segment_len = w->segment_len,
+	};
+
+	w->err = notecard_transport_write(&tp, w->buf, w->buf_len);
+	w->bus_err = w->err != 0;
+	w->flushed = true;
+	w->segment_len = tp.segment_len;
+	w->buf_len = 0;
+}
+
+static void prv_put(struct notecard_writer *w, const char *data, size_t len)
+{
+	while (len > 0 && !w->err) {
+		size_t n = MIN(len, sizeof(w->buf) - w->buf_len);
+
+		memcpy(&w->buf[w->buf_len], data, n);
+		w->buf_len += n;
+		data += n;
+		len -= n;
+
+		if (w->buf_len == sizeof(w->buf)) {
+			prv_flush(w);
+		}
+	}
+}
+
+static void prv_put_str(struct notecard_writer *w, const char *str)
+{
+	prv_put(w, str, strlen(str));
+}
+
+/**
+ * @brief Write a quoted JSON string, escaping characters as needed.
+ */
+static void prv_put_quoted(struct notecard_writer *w, const char *str)
+{
+	static const char hex[] = "0123456789abcdef";
+	const char *start = str;
+
+	prv_put(w, "\"", 1);
+
+	/* Runs of characters that do not need escaping are written at once. */
+	for (; *str; str++) {
+		uint8_t c = *str;
+		char esc[6] = {'\\'};
+		size_t esc_len = 2;
+
+		switch (c) {
+		case '"':
+		case '\\':
+			esc[1] = c;
+			break;
+		case '\n':
+			esc[1] = 'n';
+			break;
+		case '\r':
+			esc[1] = 'r';
+			break;
+		case '\t':
+			esc[1] = 't';
+			break;
+		default:
+			if (c >= 0x20) {
+				continue;
+			}
+			memcpy(&esc[1], "u00", 3);
+			esc[4] = hex[c >> 4];
+			esc[5] = hex[c & 0xF];
+			esc_len = 6;
+			break;
+		}
+
+		prv_put(w, start, str - start);
+		prv_put(w, esc, esc_len);
+		start = str + 1;
+	}
+
+	prv_put(w, start, str - start);
+	prv_put(w, "\"", 1);
+}
+
+/**
+ * @brief Write key of a field, preceded by a comma if needed.
+ */
+static void prv_put_key(struct notecard_writer *w, const char *key)
+{
+	__ASSERT(key, "Key needs to be provided");
+
+	if (w->has_fields & BIT(w->depth)) {
+		prv_put(w, ",", 1);
+	}
+	w->has_fields |= BIT(w->depth);
+
+	prv_put_quoted(w, key);
+	prv_put(w, ":", 1);
+}
+
+static void prv_begin(struct notecard_writer *w, const struct device *dev, const char *key,
+		      const char *name)
+{
+	__ASSERT(name, "Request name needs to be provided");
+
+	struct notecard_transport tp;
+
+	/* Asserts that control is taken. */
+	notecard_transport_init(&tp, dev);
+
+	w->dev = dev;
+	w->segment_len = tp.segment_len;
+	w->has_fields = 0;
+	w->depth = 0;
+	w->is_cmd = strcmp(key, "cmd") == 0;
+	w->err = 0;
+	w->bus_err = false;
+	w->flushed = false;
+	w->buf_len = 0;
+
+	prv_put(w, "{", 1);
+	notecard_writer_add_string(w, key, name);
+}
+
+void notecard_writer_req_begin(struct notecard_writer *w, const struct device *dev,
+			       const char *req)
+{
+	prv_begin(w, dev, "req", req);
+}
+
+void notecard_writer_cmd_begin(struct notecard_writer *w, const struct device *dev,
+			       const char *cmd)
+{
+	prv_begin(w, dev, "cmd", cmd);
+}
+
+void notecard_writer_add_string(struct notecard_writer *w, const char *key, const char *value)
+{
+	__ASSERT(value, "Value needs to be provided");
+
+	prv_put_key(w, key);
+	prv_put_quoted(w, value);
+}
+
+void notecard_writer_add_int(struct notecard_writer *w, const char *key, JINTEGER value)
+{
+	char num[JNTOA_MAX];
+
+	JItoA(value, num);
+	prv_put_key(w, key);
+	prv_put_str(w, num);
+}
+
+void notecard_writer_add_number(struct notecard_writer *w, const char *key, JNUMBER value)
+{
+	char num[JNTOA_MAX];
+
+	JNtoA(value, num, JNTOA_PRECISION);
+	prv_put_key(w, key);
+	prv_put_str(w, num);
+}
+
+void notecard_writer_add_bool(struct notecard_writer *w, const char *key, bool value)
+{
+	prv_put_key(w, key);
+	prv_put_str(w, value ? "true" : "false");
+}
+
+void notecard_writer_put_key(struct notecard_writer *w, const char *key)
+{
+	prv_put_key(w, key);
+}
+
+void notecard_writer_put(struct notecard_writer *w, const char *data, size_t len)
+{
+	prv_put(w, data, len);
+}
+
+void notecard_writer_object_begin(struct notecard_writer *w, const char *key)
+{
+	if (w->depth == WRITER_MAX_DEPTH) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	prv_put_key(w, key);
+	prv_put(w, "{", 1);
+	w->depth++;
+	w->has_fields &= ~BIT(w->depth);
+}
+
+void notecard_writer_object_end(struct notecard_writer *w)
+{
+	if (w->depth == 0) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	prv_put(w, "}", 1);
+	w->depth--;
+}
+
+/**
+ * @brief Terminate the part of a failed request that was already transmitted.
+ *
+ * Notecard rejects the unfinished line, its error response is read and dropped, so the next
+ * request starts on a fresh line.
+ */
+static void prv_abort(struct notecard_writer *w)
+{
+	const struct notecard_config *config = w->dev->config;
+	struct notecard_transport tp = {
+		.dev = w->dev,
+		.bus = &config->bus,
+		.segment_len = w->segment_len,
+	};
+	char scratch[32];
+
+	if (notecard_transport_write(&tp, "\n", 1) == 0) {
+		notecard_transport_read_line(&tp, scratch, sizeof(scratch),
+					     K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+	}
+}
+
+/**
+ * @brief Transmit the end of the request.
+ *
+ * @return 0 on success, negative error code otherwise.
+ */
+static int prv_finish(struct notecard_writer *w)
+{
+	if (w->depth != 0 && !w->err) {
+		w->err = -EINVAL;
+	}
+
+	prv_put(w, "}\n", 2);
+	prv_flush(w);
+
+	if (!w->err) {
+		return 0;
+	}
+
+	/* Bytes that are still buffered are never sent. If the bus failed, it is not known what
+	 * reached the notecard, so nothing more is sent. */
+	if (w->flushed && !w->bus_err) {
+		prv_abort(w);
+	}
+
+	LOG_ERR("Failed to write request (err=%d)", w->err);
+
+	return w->err;
+}
+
+int notecard_writer_end(struct notecard_writer *w, char *rsp, size_t rsp_size)
+{
+	int rc = prv_finish(w);
+
+	if (rc || w->is_cmd) {
+		return rc;
+	}
+
+	/* Response still needs to be read, even if the caller does not need it. */
+	char scratch[32];
+	bool keep_rsp = rsp != NULL;
+
+	if (!keep_rsp) {
+		rsp = scratch;
+		rsp_size = sizeof(scratch);
+	}
+
+	const struct notecard_config *config = w->dev->config;
+	struct notecard_transport tp = {
+		.dev = w->dev,
+		.bus = &config->bus,
+	};
+
+	rc = notecard_transport_read_line(&tp, rsp, rsp_size, K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+	if (rc == -EMSGSIZE && !keep_rsp) {
+		return 0;
+	}
+	if (rc < 0) {
+		LOG_ERR("Failed to read response (err=%d)", rc);
+		return rc;
+	}
+
+	return 0;
+}
+
+#if CONFIG_NOTECARD_JSON_PARSER
+int notecard_writer_end_parse(struct notecard_writer *w, notecard_json_cb_t cb, void *user_data)
+{
+	__ASSERT(!w->is_cmd, "Notecard does not respond to commands");
+
+	int rc = prv_finish(w);
+	if (rc) {
+		return rc;
+	}
+
+	const struct notecard_config *config = w->dev->config;
+	struct notecard_transport tp = {
+		.dev = w->dev,
+		.bus = &config->bus,
+	};
+	struct notecard_json_parser p;
+
+	notecard_json_parser_init(&p, cb, user_data);
+
+	return notecard_transport_read_parse(&tp, &p, K_MSEC(CONFIG_NOTECARD_RSP_TIMEOUT_MS));
+}
+#endif
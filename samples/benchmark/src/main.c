@@ -0,0 +1,213 @@
+/** @file main.c
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include <notecard.h>
+
+#include <note.h>
+
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(main);
+
+#define PAYLOAD_SIZE 1024
+#define ITERATIONS   10
+
+const struct device *prv_notecard_dev = DEVICE_DT_GET(DT_NODELABEL(notecard));
+
+static char prv_payload[PAYLOAD_SIZE + 1];
+static uint8_t prv_binary[PAYLOAD_SIZE];
+static uint8_t prv_binary_rx[PAYLOAD_SIZE];
+
+/**
+ * @brief Return cpu cycles spent by the current thread so far.
+ */
+static uint64_t prv_thread_cycles(void)
+{
+	k_thread_runtime_stats_t stats;
+
+	k_thread_runtime_stats_get(k_current_get(), &stats);
+
+	return stats.execution_cycles;
+}
+
+/**
+ * @brief Send a single large request and log how long it took.
+ *
+ * @return True if request succeeded, false otherwise.
+ */
+static bool prv_bench_transmit(void)
+{
+	J *req = NoteNewRequest("note.update");
+	JAddStringToObject(req, "file", "bench.dbx");
+	JAddStringToObject(req, "note", "bench");
+	J *body = JAddObjectToObject(req, "body");
+	JAddStringToObject(body, "payload", prv_payload);
+
+	uint64_t cycles_start = prv_thread_cycles();
+	int64_t start = k_uptime_get();
+
+	J *rsp = NoteRequestResponse(req);
+
+	int64_t duration_ms = k_uptime_get() - start;
+	uint64_t cpu_us = k_cyc_to_us_floor64(prv_thread_cycles() - cycles_start);
+
+	bool ok = rsp && !NoteResponseError(rsp);
+	NoteDeleteResponse(rsp);
+
+	if (!ok) {
+		LOG_ERR("Request failed");
+		return false;
+	}
+
+	LOG_INF("tx: %d bytes in %lld ms (%lld B/s), cpu time %llu us", PAYLOAD_SIZE, duration_ms,
+		duration_ms ? (PAYLOAD_SIZE * 1000LL) / duration_ms : 0, cpu_us);
+
+	return true;
+}
+
+/**
+ * @brief Stream the same large request as prv_bench_transmit() and log how long it took.
+ *
+ * Request is written straight to the bus, so no cJSON tree nor serialized copy is allocated.
+ *
+ * @return True if request succeeded, false otherwise.
+ */
+static bool prv_bench_stream(void)
+{
+	struct notecard_writer w;
+	char rsp[64];
+
+	int64_t start = k_uptime_get();
+
+	notecard_writer_req_begin(&w, prv_notecard_dev, "note.update");
+	notecard_writer_add_string(&w, "file", "bench.dbx");
+	notecard_writer_add_string(&w, "note", "bench");
+	notecard_writer_object_begin(&w, "body");
+	notecard_writer_add_string(&w, "payload", prv_payload);
+	notecard_writer_object_end(&w);
+
+	int rc = notecard_writer_end(&w, rsp, sizeof(rsp));
+
+	int64_t duration_ms = k_uptime_get() - start;
+
+	if (rc || strstr(rsp, "\"err\"")) {
+		LOG_ERR("Streamed request failed (err=%d)", rc);
+		return false;
+	}
+
+	LOG_INF("stream: %d bytes in %lld ms (%lld B/s)", PAYLOAD_SIZE, duration_ms,
+		duration_ms ? (PAYLOAD_SIZE * 1000LL) / duration_ms : 0);
+
+	return true;
+}
+
+/**
+ * @brief Write binary payload to the binary storage area, read it back and log throughput of
+ * both directions.
+ */
+static void prv_bench_binary(void)
+{
+	struct notecard_binary_stats put_stats;
+	struct notecard_binary_stats get_stats;
+
+	J *req = NoteNewRequest("card.binary");
+	JAddBoolToObject(req, "delete", true);
+	NoteRequest(req);
+
+	int rc = notecard_binary_put(prv_notecard_dev, 0, prv_binary, sizeof(prv_binary),
+				     &put_stats);
+	if (rc) {
+		LOG_ERR("Binary put failed (err=%d)", rc);
+		return;
+	}
+
+	rc = notecard_binary_get(prv_notecard_dev, 0, prv_binary_rx, sizeof(prv_binary_rx),
+				 &get_stats);
+	if (rc) {
+		LOG_ERR("Binary get failed (err=%d)", rc);
+		return;
+	}
+
+	if (memcmp(prv_binary, prv_binary_rx, sizeof(prv_binary)) != 0) {
+		LOG_ERR("Binary data does not match");
+		return;
+	}
+
+	LOG_INF("binary: put %u B/s, get %u B/s", put_stats.bytes_per_sec,
+		get_stats.bytes_per_sec);
+}
+
+/**
+ * @brief Create a small write request, whose response is usually thrown away.
+ */
+static J *prv_small_request(void)
+{
+	J *req = NoteNewRequest("note.update");
+	JAddStringToObject(req, "file", "bench.dbx");
+	JAddStringToObject(req, "note", "small");
+	J *body = JAddObjectToObject(req, "body");
+	JAddNumberToObject(body, "value", 42);
+
+	return req;
+}
+
+/**
+ * @brief Compare latency of a request with response against the same request sent as a
+ * command.
+ */
+static void prv_bench_cmd_latency(void)
+{
+	int64_t start = k_uptime_get();
+
+	J *rsp = NoteRequestResponse(prv_small_request());
+	NoteDeleteResponse(rsp);
+
+	int64_t req_ms = k_uptime_get() - start;
+
+	start = k_uptime_get();
+
+	int rc = notecard_cmd(prv_notecard_dev, prv_small_request());
+
+	int64_t cmd_ms = k_uptime_get() - start;
+
+	LOG_INF("latency: request %lld ms, command %lld ms (err=%d)", req_ms, cmd_ms, rc);
+}
+
+int main(void)
+{
+	memset(prv_payload, 'x', PAYLOAD_SIZE);
+
+	for (size_t i = 0; i < sizeof(prv_binary); i++) {
+		/* Pattern with zeros, which need to be COBS encoded. */
+		prv_binary[i] = i % 7 == 0 ? 0 : (uint8_t)i;
+	}
+
+	notecard_ctrl_take(prv_notecard_dev);
+	bool present = notecard_is_present(prv_notecard_dev);
+	notecard_ctrl_release(prv_notecard_dev);
+
+	if (!present) {
+		LOG_ERR("Notecard not present, stopping sample.");
+		return 0;
+	}
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		notecard_ctrl_take(prv_notecard_dev);
+		prv_bench_transmit();
+		prv_bench_stream();
+		prv_bench_binary();
+		prv_bench_cmd_latency();
+		notecard_ctrl_release(prv_notecard_dev);
+	}
+
+	LOG_INF("Benchmark done");
+
+	return 0;
+}
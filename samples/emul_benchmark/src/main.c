@@ -0,0 +1,224 @@
+/** @file main.c
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include <notecard.h>
+
+#include <note.h>
+
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(main);
+
+#define PAYLOAD_SIZE 1024
+#define ITERATIONS   50
+
+const struct device *prv_notecard_dev = DEVICE_DT_GET(DT_NODELABEL(notecard));
+
+static char prv_payload[PAYLOAD_SIZE + 1];
+
+struct sensor_note {
+	float temp;
+	uint16_t humidity;
+	bool door_open;
+	char status[16];
+};
+
+NOTECARD_SCHEMA_DEFINE(prv_sensor_schema, struct sensor_note, "sensors.qo", temp, humidity,
+		       door_open, status);
+
+static const struct sensor_note prv_sensor_note = {
+	.temp = 21.5f,
+	.humidity = 45,
+	.door_open = true,
+	.status = "ok",
+};
+
+NOTECARD_STATIC_REQUEST(prv_version_req, "{\"req\":\"card.version\"}");
+
+/* Requests that the emulator answers, sent without any arguments. */
+static const char *const prv_requests[] = {"card.version", "card.status", "hub.status",
+					   "card.temp"};
+
+/**
+ * @brief Create a note.update request, with a payload of given size.
+ */
+static J *prv_update_request(size_t payload_size)
+{
+	J *req = NoteNewRequest("note.update");
+	JAddStringToObject(req, "file", "bench.dbx");
+	JAddStringToObject(req, "note", "bench");
+	J *body = JAddObjectToObject(req, "body");
+	JAddStringToObject(body, "payload", &prv_payload[PAYLOAD_SIZE - payload_size]);
+
+	return req;
+}
+
+/**
+ * @brief Send the request ITERATIONS times and log requests/s, bytes/s and time per request.
+ *
+ * @param[in] name		Name of the request.
+ * @param[in] payload_size	Payload of note.update request, 0 sends the request without any
+ *				arguments.
+ */
+static void prv_bench(const char *name, size_t payload_size)
+{
+	int64_t ticks = 0;
+	int failed = 0;
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		J *req = payload_size ? prv_update_request(payload_size) : NoteNewRequest(name);
+
+		int64_t start = k_uptime_ticks();
+
+		J *rsp = NoteRequestResponse(req);
+
+		ticks += k_uptime_ticks() - start;
+
+		if (!rsp || NoteResponseError(rsp)) {
+			failed++;
+		}
+
+		NoteDeleteResponse(rsp);
+	}
+
+	uint64_t us = k_ticks_to_us_floor64(ticks);
+
+	LOG_INF("%s (%zu B): %llu req/s, %llu B/s, %llu us/req, %d failed", name, payload_size,
+		us ? (ITERATIONS * 1000000ULL) / us : 0,
+		us ? (ITERATIONS * payload_size * 1000000ULL) / us : 0, us / ITERATIONS, failed);
+}
+
+/**
+ * @brief Send the constant card.version request ITERATIONS times and log time per request, to
+ * compare it with the card.version request that is built with cJSON.
+ */
+static void prv_bench_static(void)
+{
+	static char rsp[512];
+	int failed = 0;
+	int64_t start = k_uptime_ticks();
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		if (notecard_request_static(prv_notecard_dev, &prv_version_req, rsp, sizeof(rsp))) {
+			failed++;
+		}
+	}
+
+	uint64_t us = k_ticks_to_us_floor64(k_uptime_ticks() - start);
+
+	LOG_INF("card.version (static): %llu us/req, %d failed", us / ITERATIONS, failed);
+}
+
+/**
+ * @brief Add the same note ITERATIONS times, built with cJSON and with its schema, and log time
+ * and bytes transmitted per note.
+ */
+static void prv_bench_schema(void)
+{
+	struct notecard_stats stats;
+	uint32_t tx_bytes;
+	int64_t start;
+	int failed = 0;
+
+	notecard_stats_get(prv_notecard_dev, &stats);
+	tx_bytes = stats.tx_bytes;
+	start = k_uptime_ticks();
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		J *req = NoteNewRequest("note.add");
+		JAddStringToObject(req, "file", prv_sensor_schema.file);
+		J *body = JAddObjectToObject(req, "body");
+		JAddNumberToObject(body, "temp", prv_sensor_note.temp);
+		JAddIntToObject(body, "humidity", prv_sensor_note.humidity);
+		JAddBoolToObject(body, "door_open", prv_sensor_note.door_open);
+		JAddStringToObject(body, "status", prv_sensor_note.status);
+
+		J *rsp = NoteRequestResponse(req);
+
+		if (!rsp || NoteResponseError(rsp)) {
+			failed++;
+		}
+
+		NoteDeleteResponse(rsp);
+	}
+
+	uint64_t us = k_ticks_to_us_floor64(k_uptime_ticks() - start);
+
+	notecard_stats_get(prv_notecard_dev, &stats);
+	LOG_INF("note.add (cJSON): %llu us/note, %u B/note, %d failed", us / ITERATIONS,
+		(stats.tx_bytes - tx_bytes) / ITERATIONS, failed);
+
+	/* First note registers the template, it is not measured. */
+	failed = notecard_note_add(prv_notecard_dev, &prv_sensor_schema, &prv_sensor_note) ? 1 : 0;
+
+	notecard_stats_get(prv_notecard_dev, &stats);
+	tx_bytes = stats.tx_bytes;
+	start = k_uptime_ticks();
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		if (notecard_note_add(prv_notecard_dev, &prv_sensor_schema, &prv_sensor_note)) {
+			failed++;
+		}
+	}
+
+	us = k_ticks_to_us_floor64(k_uptime_ticks() - start);
+
+	notecard_stats_get(prv_notecard_dev, &stats);
+	LOG_INF("note.add (schema): %llu us/note, %u B/note, %d failed", us / ITERATIONS,
+		(stats.tx_bytes - tx_bytes) / ITERATIONS, failed);
+}
+
+int main(void)
+{
+	memset(prv_payload, 'x', PAYLOAD_SIZE);
+
+	notecard_ctrl_take(prv_notecard_dev);
+	bool present = notecard_is_present(prv_notecard_dev);
+	notecard_ctrl_release(prv_notecard_dev);
+
+	if (!present) {
+		LOG_ERR("Emulated notecard not present, stopping sample.");
+		return 0;
+	}
+
+	notecard_ctrl_take(prv_notecard_dev);
+
+	for (size_t i = 0; i < ARRAY_SIZE(prv_requests); i++) {
+		prv_bench(prv_requests[i], 0);
+	}
+
+	prv_bench("note.update", 64);
+	prv_bench("note.update", PAYLOAD_SIZE);
+	prv_bench_static();
+	prv_bench_schema();
+
+	struct notecard_mem_stats mem_stats;
+	int rc = notecard_mem_stats_get(prv_notecard_dev, &mem_stats);
+
+	notecard_ctrl_release(prv_notecard_dev);
+
+	if (rc == 0) {
+		LOG_INF("heap: peak %zu B, %u failed allocations", mem_stats.max_allocated_bytes,
+			mem_stats.alloc_failures);
+	}
+
+	struct notecard_stats stats;
+
+	notecard_stats_get(prv_notecard_dev, &stats);
+
+	LOG_INF("bus: tx %u B, rx %u B, response wait avg %u us, max %u us", stats.tx_bytes,
+		stats.rx_bytes,
+		stats.rx_wait.count ? (uint32_t)(stats.rx_wait.total_us / stats.rx_wait.count) : 0,
+		stats.rx_wait.max_us);
+
+	LOG_INF("Benchmark done");
+
+	return 0;
+}
@@ -9,7 +9,10 @@
 
 #include <note.h>
 
+#include <string.h>
+
 #include <zephyr/device.h>
+#include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
 #include <zephyr/logging/log_ctrl.h>
 
@@ -21,6 +24,46 @@ void callback(const struct device *dev, void *user_data)
 {
 	const struct device *user_dev = user_data;
 	LOG_INF("Hello from %s", user_dev->name);
+
+#if CONFIG_NOTECARD_ATTN_DEFERRED
+	/* Callback runs in a workqueue, so it could also take control of the notecard here. */
+	struct notecard_attn_event event;
+
+	notecard_attn_event_get(dev, &event);
+	LOG_INF("Attn fired %u time(s), last at %lld ms", event.count, event.timestamp);
+#endif
+}
+
+/* Arm attn pin (it will go low) and set it to timeout after 1 second (it goes high then). Request
+ * is constant, so it is kept in flash and sent without building it on the heap every time. */
+NOTECARD_STATIC_REQUEST(attn_arm_req, "{\"req\":\"card.attn\",\"mode\":\"arm\",\"seconds\":1}");
+
+/* Static requests are sent once, so failed attempts are retried for up to this long, like
+ * NoteRequestResponseWithRetry() does. */
+#define REQUEST_RETRY_TIMEOUT_MS 3000
+#define REQUEST_RETRY_DELAY_MS	 250
+
+/**
+ * @brief Send the static request, retrying it on bus errors, timeouts and {io} error responses.
+ */
+static int request_with_retry(const struct notecard_static_request *req, char *rsp,
+			      size_t rsp_size)
+{
+	k_timepoint_t end = sys_timepoint_calc(K_MSEC(REQUEST_RETRY_TIMEOUT_MS));
+	int rc;
+
+	while (true) {
+		rc = notecard_request_static(notecard_dev, req, rsp, rsp_size);
+
+		/* Response did not fit, sending it again would not help. */
+		bool retry = rc ? rc != -EMSGSIZE : strstr(rsp, "{io}") != NULL;
+
+		if (!retry || sys_timepoint_expired(end)) {
+			return rc;
+		}
+
+		k_msleep(REQUEST_RETRY_DELAY_MS);
+	}
 }
 
 int main(void)
@@ -28,26 +71,19 @@ int main(void)
 	/* In last argument pass the device as user data just for demonstration purposes. */
 	notecard_attn_cb_register(notecard_dev, callback, (void *)notecard_dev);
 
-	/* Create a request */
 	while (1) {
-		/* Arm attn pin (it will go low) and set it to timeout after 1 second (it goes high
-		 * then). */
+		char rsp[128];
+
 		notecard_ctrl_take(notecard_dev);
-		J *req = NoteNewRequest("card.attn");
-		JAddStringToObject(req, "mode", "arm");
-		JAddNumberToObject(req, "seconds", 1);
-
-		J *rsp = NoteRequestResponseWithRetry(req, 3);
-		char *rsp_str = JPrint(rsp);
-		if (rsp) {
-			LOG_INF("%s", rsp_str);
-			JFree(rsp_str);
-		} else {
+		int rc = request_with_retry(&attn_arm_req, rsp, sizeof(rsp));
+		notecard_ctrl_release(notecard_dev);
+
+		if (rc) {
 			LOG_INF("No response");
+		} else {
+			LOG_INF("%s", rsp);
 		}
-		NoteDeleteResponse(rsp);
 
-		notecard_ctrl_release(notecard_dev);
 		LOG_INF("Sleeping for 3 s");
 		k_msleep(3000);
 	}
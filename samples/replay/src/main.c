@@ -0,0 +1,109 @@
+/** @file main.c
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include <notecard.h>
+
+#include <note.h>
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(main);
+
+#define ITERATIONS 20
+
+/* Requests in the same order as they were captured. */
+static const char *const prv_requests[] = {"card.version", "hub.status", "card.temp"};
+
+extern const uint8_t session[];
+extern const size_t session_len;
+
+const struct device *prv_notecard_dev = DEVICE_DT_GET(DT_NODELABEL(notecard));
+
+/**
+ * @brief Return cpu cycles spent by the current thread so far.
+ */
+static uint64_t prv_thread_cycles(void)
+{
+	k_thread_runtime_stats_t stats;
+
+	k_thread_runtime_stats_get(k_current_get(), &stats);
+
+	return stats.execution_cycles;
+}
+
+/**
+ * @brief Replay the whole session once.
+ *
+ * @return Number of failed requests.
+ */
+static int prv_replay(uint64_t *cycles, int64_t *duration_ms)
+{
+	int failed = 0;
+
+	notecard_ctrl_take(prv_notecard_dev);
+
+	for (size_t i = 0; i < ARRAY_SIZE(prv_requests); i++) {
+		J *req = NoteNewRequest(prv_requests[i]);
+
+		uint64_t cycles_start = prv_thread_cycles();
+		int64_t start = k_uptime_get();
+
+		J *rsp = NoteRequestResponse(req);
+
+		*duration_ms += k_uptime_get() - start;
+		*cycles += prv_thread_cycles() - cycles_start;
+
+		if (!rsp || NoteResponseError(rsp)) {
+			LOG_ERR("%s failed", prv_requests[i]);
+			failed++;
+		}
+
+		NoteDeleteResponse(rsp);
+	}
+
+	notecard_ctrl_release(prv_notecard_dev);
+
+	if (!notecard_replay_done()) {
+		LOG_WRN("Session was not replayed to the end");
+	}
+
+	return failed;
+}
+
+int main(void)
+{
+	uint64_t cycles = 0;
+	int64_t duration_ms = 0;
+	int failed = 0;
+
+	LOG_INF("Booted");
+
+	for (int i = 0; i < ITERATIONS; i++) {
+		int rc = notecard_replay_load(session, session_len);
+		if (rc) {
+			LOG_ERR("Malformed session (err=%d)", rc);
+			return 0;
+		}
+
+		failed += prv_replay(&cycles, &duration_ms);
+	}
+
+	int num_requests = ITERATIONS * ARRAY_SIZE(prv_requests);
+	struct notecard_stats stats;
+
+	notecard_stats_get(prv_notecard_dev, &stats);
+
+	LOG_INF("Replayed %d requests, %d failed", num_requests, failed);
+	LOG_INF("Per request: %u ms, %u us cpu", (uint32_t)(duration_ms / num_requests),
+		(uint32_t)(k_cyc_to_us_floor64(cycles) / num_requests));
+	LOG_INF("Response wait: avg %u us, max %u us",
+		stats.rx_wait.count ? (uint32_t)(stats.rx_wait.total_us / stats.rx_wait.count) : 0,
+		stats.rx_wait.max_us);
+
+	return 0;
+}
@@ -0,0 +1,51 @@
+/** @file session.c
+ *
+ * @brief Captured session of card.version, hub.status and card.temp requests.
+ *
+ * Array is the output of "notecard capture dump" shell command, taken with
+ * CONFIG_NOTECARD_CAPTURE enabled.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+const uint8_t session[] = {
+	0x30, 0x1b, 0x0f, 0x00, 0x01, 0x00, 0x00, 0x00, 0x0a, 0x1e, 0x1e, 0x0f, 0x00, 0x02, 0x00, 0x01,
+	0x00, 0x0d, 0x0a, 0x40, 0x42, 0x0f, 0x00, 0x17, 0x00, 0x00, 0x00, 0x7b, 0x22, 0x72, 0x65, 0x71,
+	0x22, 0x3a, 0x22, 0x63, 0x61, 0x72, 0x64, 0x2e, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x22,
+	0x7d, 0x0a, 0x62, 0xe3, 0x0f, 0x00, 0x1a, 0x01, 0x01, 0x00, 0x7b, 0x22, 0x62, 0x6f, 0x64, 0x79,
+	0x22, 0x3a, 0x7b, 0x22, 0x6f, 0x72, 0x67, 0x22, 0x3a, 0x22, 0x42, 0x6c, 0x75, 0x65, 0x73, 0x20,
+	0x57, 0x69, 0x72, 0x65, 0x6c, 0x65, 0x73, 0x73, 0x22, 0x2c, 0x22, 0x70, 0x72, 0x6f, 0x64, 0x75,
+	0x63, 0x74, 0x22, 0x3a, 0x22, 0x4e, 0x6f, 0x74, 0x65, 0x63, 0x61, 0x72, 0x64, 0x22, 0x2c, 0x22,
+	0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x22, 0x3a, 0x22, 0x6e, 0x6f, 0x74, 0x65, 0x63, 0x61,
+	0x72, 0x64, 0x2d, 0x37, 0x2e, 0x32, 0x2e, 0x32, 0x22, 0x2c, 0x22, 0x76, 0x65, 0x72, 0x5f, 0x6d,
+	0x61, 0x6a, 0x6f, 0x72, 0x22, 0x3a, 0x37, 0x2c, 0x22, 0x76, 0x65, 0x72, 0x5f, 0x6d, 0x69, 0x6e,
+	0x6f, 0x72, 0x22, 0x3a, 0x32, 0x2c, 0x22, 0x76, 0x65, 0x72, 0x5f, 0x70, 0x61, 0x74, 0x63, 0x68,
+	0x22, 0x3a, 0x32, 0x2c, 0x22, 0x76, 0x65, 0x72, 0x5f, 0x62, 0x75, 0x69, 0x6c, 0x64, 0x22, 0x3a,
+	0x31, 0x36, 0x33, 0x33, 0x37, 0x7d, 0x2c, 0x22, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e, 0x22,
+	0x3a, 0x22, 0x6e, 0x6f, 0x74, 0x65, 0x63, 0x61, 0x72, 0x64, 0x2d, 0x37, 0x2e, 0x32, 0x2e, 0x32,
+	0x2e, 0x31, 0x36, 0x33, 0x33, 0x37, 0x22, 0x2c, 0x22, 0x64, 0x65, 0x76, 0x69, 0x63, 0x65, 0x22,
+	0x3a, 0x22, 0x64, 0x65, 0x76, 0x3a, 0x38, 0x36, 0x30, 0x33, 0x32, 0x32, 0x30, 0x36, 0x38, 0x30,
+	0x31, 0x32, 0x33, 0x34, 0x35, 0x22, 0x2c, 0x22, 0x6e, 0x61, 0x6d, 0x65, 0x22, 0x3a, 0x22, 0x42,
+	0x6c, 0x75, 0x65, 0x73, 0x20, 0x57, 0x69, 0x72, 0x65, 0x6c, 0x65, 0x73, 0x73, 0x20, 0x4e, 0x6f,
+	0x74, 0x65, 0x63, 0x61, 0x72, 0x64, 0x22, 0x2c, 0x22, 0x73, 0x6b, 0x75, 0x22, 0x3a, 0x22, 0x4e,
+	0x4f, 0x54, 0x45, 0x2d, 0x57, 0x42, 0x4e, 0x41, 0x4e, 0x22, 0x2c, 0x22, 0x62, 0x6f, 0x61, 0x72,
+	0x64, 0x22, 0x3a, 0x22, 0x31, 0x2e, 0x31, 0x31, 0x22, 0x2c, 0x22, 0x61, 0x70, 0x69, 0x22, 0x3a,
+	0x37, 0x7d, 0x0d, 0x0a, 0x90, 0x05, 0x10, 0x00, 0x15, 0x00, 0x00, 0x00, 0x7b, 0x22, 0x72, 0x65,
+	0x71, 0x22, 0x3a, 0x22, 0x68, 0x75, 0x62, 0x2e, 0x73, 0x74, 0x61, 0x74, 0x75, 0x73, 0x22, 0x7d,
+	0x0a, 0xb4, 0xf9, 0x10, 0x00, 0x44, 0x00, 0x01, 0x00, 0x7b, 0x22, 0x73, 0x74, 0x61, 0x74, 0x75,
+	0x73, 0x22, 0x3a, 0x22, 0x63, 0x6f, 0x6e, 0x6e, 0x65, 0x63, 0x74, 0x65, 0x64, 0x20, 0x28, 0x73,
+	0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x6f, 0x70, 0x65, 0x6e, 0x29, 0x20, 0x7b, 0x63, 0x6f,
+	0x6e, 0x6e, 0x65, 0x63, 0x74, 0x65, 0x64, 0x7d, 0x22, 0x2c, 0x22, 0x63, 0x6f, 0x6e, 0x6e, 0x65,
+	0x63, 0x74, 0x65, 0x64, 0x22, 0x3a, 0x74, 0x72, 0x75, 0x65, 0x7d, 0x0d, 0x0a, 0x00, 0x17, 0x11,
+	0x00, 0x14, 0x00, 0x00, 0x00, 0x7b, 0x22, 0x72, 0x65, 0x71, 0x22, 0x3a, 0x22, 0x63, 0x61, 0x72,
+	0x64, 0x2e, 0x74, 0x65, 0x6d, 0x70, 0x22, 0x7d, 0x0a, 0x7c, 0xa9, 0x11, 0x00, 0x26, 0x00, 0x01,
+	0x00, 0x7b, 0x22, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x22, 0x3a, 0x32, 0x33, 0x2e, 0x35, 0x36, 0x32,
+	0x35, 0x2c, 0x22, 0x63, 0x61, 0x6c, 0x69, 0x62, 0x72, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x22, 0x3a,
+	0x2d, 0x33, 0x2e, 0x30, 0x7d, 0x0d, 0x0a,
+};
+
+const size_t session_len = sizeof(session);
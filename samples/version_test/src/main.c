@@ -20,11 +20,11 @@ const struct device *prv_notecard_dev = DEVICE_DT_GET(DT_NODELABEL(notecard));
 int main(void)
 {
 	LOG_INF("Booted");
-	k_msleep(1000);
 
+	/* Notecard might still be booting, continue as soon as it responds. */
 	notecard_ctrl_take(prv_notecard_dev);
-	bool present = notecard_is_present(prv_notecard_dev);
-	if (!present) {
+	int rc = notecard_wait_ready(prv_notecard_dev, K_SECONDS(5));
+	if (rc) {
 		LOG_ERR("Notecard not present, stopping sample.");
 		return 0;
 	}
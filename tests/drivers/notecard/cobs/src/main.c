@@ -0,0 +1,280 @@
+/** @file main.c
+ *
+ * @brief COBS encoder and decoder tests.
+ *
+ * Data is encoded into output chunks of every size and compared against known encodings, which
+ * cover zeros at the start and the end of the data and blocks of the maximal length. Random data
+ * with different densities of zeros is then encoded and decoded back. Tests also assert that the
+ * decoder rejects data that does not fit into its buffer or is not correctly encoded.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+/* Every encoded byte is XOR-ed with the newline, which terminates the encoded data. */
+#define COBS_EOP '\n'
+
+#define DATA_MAX_LEN 700
+/* Worst case is one code byte per 254 bytes of data, plus the terminating newline. */
+#define ENC_MAX_LEN  (DATA_MAX_LEN + DATA_MAX_LEN / 254 + 2)
+
+/* Data and its COBS encoding, before it is XOR-ed and terminated. */
+struct cobs_vector {
+	const uint8_t *data;
+	size_t len;
+	const uint8_t *enc;
+	size_t enc_len;
+};
+
+static uint8_t prv_data[DATA_MAX_LEN];
+static uint8_t prv_enc[ENC_MAX_LEN];
+static uint8_t prv_dec[DATA_MAX_LEN];
+
+/**
+ * @brief Encode the data, output is taken from the encoder in chunks of the given length.
+ *
+ * @return Number of encoded bytes, including the terminating newline.
+ */
+static size_t prv_encode(const uint8_t *data, size_t len, size_t chunk_len)
+{
+	struct notecard_cobs_encoder enc;
+	size_t enc_len = 0;
+	size_t n;
+
+	notecard_cobs_encoder_init(&enc, data, len);
+
+	do {
+		n = notecard_cobs_encode(&enc, &prv_enc[enc_len],
+					 MIN(chunk_len, sizeof(prv_enc) - enc_len));
+		enc_len += n;
+	} while (n > 0);
+
+	/* Encoded data can be terminated with a newline, since it contains no other. */
+	zassert_true(enc.done, "Encoded data is too long");
+	zassert_equal(prv_enc[enc_len - 1], COBS_EOP, "Encoded data is not terminated");
+	zassert_is_null(memchr(prv_enc, COBS_EOP, enc_len - 1), "Encoded data contains a newline");
+	zassert_equal(enc_len - 1, notecard_cobs_encoded_len(data, len),
+		      "Encoded length does not match");
+
+	return enc_len;
+}
+
+/**
+ * @brief Decode the encoded data, without its terminating newline.
+ *
+ * @return Same as notecard_cobs_decoder_finish(), or the error of notecard_cobs_decode().
+ */
+static int prv_decode(const uint8_t *enc, size_t enc_len, size_t size)
+{
+	struct notecard_cobs_decoder dec;
+
+	notecard_cobs_decoder_init(&dec, prv_dec, size);
+
+	for (size_t i = 0; i < enc_len; i++) {
+		int rc = notecard_cobs_decode(&dec, enc[i]);
+		if (rc) {
+			return rc;
+		}
+	}
+
+	return notecard_cobs_decoder_finish(&dec);
+}
+
+static void prv_round_trip(const uint8_t *data, size_t len)
+{
+	size_t enc_len = prv_encode(data, len, 64);
+
+	zassert_equal(prv_decode(prv_enc, enc_len - 1, sizeof(prv_dec)), (int)len,
+		      "Decoded length does not match");
+	zassert_mem_equal(prv_dec, data, len, "Decoded data does not match");
+}
+
+static void prv_check_vector(const struct cobs_vector *v)
+{
+	for (size_t chunk_len = 1; chunk_len <= v->enc_len + 1; chunk_len++) {
+		zassert_equal(prv_encode(v->data, v->len, chunk_len), v->enc_len + 1,
+			      "Encoded length does not match in chunks of %zu", chunk_len);
+
+		for (size_t i = 0; i < v->enc_len; i++) {
+			zassert_equal(prv_enc[i] ^ COBS_EOP, v->enc[i],
+				      "Encoded byte %zu does not match in chunks of %zu", i,
+				      chunk_len);
+		}
+	}
+
+	prv_round_trip(v->data, v->len);
+}
+
+ZTEST(notecard_cobs, test_short_vectors)
+{
+	static const uint8_t data_0[] = {0x00};
+	static const uint8_t enc_0[] = {0x01, 0x01};
+	static const uint8_t data_1[] = {0x00, 0x00};
+	static const uint8_t enc_1[] = {0x01, 0x01, 0x01};
+	static const uint8_t data_2[] = {0x11, 0x22, 0x00, 0x33};
+	static const uint8_t enc_2[] = {0x03, 0x11, 0x22, 0x02, 0x33};
+	static const uint8_t data_3[] = {0x11, 0x22, 0x33, 0x44};
+	static const uint8_t enc_3[] = {0x05, 0x11, 0x22, 0x33, 0x44};
+	static const uint8_t data_4[] = {0x11, 0x00, 0x00, 0x00};
+	static const uint8_t enc_4[] = {0x02, 0x11, 0x01, 0x01, 0x01};
+	/* Newline in the data is encoded as any other byte. */
+	static const uint8_t data_5[] = {'\n', 0x00, '\n'};
+	static const uint8_t enc_5[] = {0x02, '\n', 0x02, '\n'};
+	static const uint8_t enc_empty[] = {0x01};
+	static const struct cobs_vector vectors[] = {
+		{NULL, 0, enc_empty, sizeof(enc_empty)},
+		{data_0, sizeof(data_0), enc_0, sizeof(enc_0)},
+		{data_1, sizeof(data_1), enc_1, sizeof(enc_1)},
+		{data_2, sizeof(data_2), enc_2, sizeof(enc_2)},
+		{data_3, sizeof(data_3), enc_3, sizeof(enc_3)},
+		{data_4, sizeof(data_4), enc_4, sizeof(enc_4)},
+		{data_5, sizeof(data_5), enc_5, sizeof(enc_5)},
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(vectors); i++) {
+		prv_check_vector(&vectors[i]);
+	}
+}
+
+ZTEST(notecard_cobs, test_full_blocks)
+{
+	static uint8_t data[256];
+	static uint8_t enc[258];
+	struct cobs_vector v = {.data = data, .enc = enc};
+
+	/* 01 .. FE, a single full block. */
+	for (size_t i = 0; i < 254; i++) {
+		data[i] = i + 1;
+		enc[i + 1] = i + 1;
+	}
+	enc[0] = 0xFF;
+	v.len = 254;
+	v.enc_len = 255;
+	prv_check_vector(&v);
+
+	/* 00 01 .. FE, zero before a full block. */
+	data[0] = 0x00;
+	enc[0] = 0x01;
+	enc[1] = 0xFF;
+	for (size_t i = 1; i < 255; i++) {
+		data[i] = i;
+		enc[i + 1] = i;
+	}
+	v.len = 255;
+	v.enc_len = 256;
+	prv_check_vector(&v);
+
+	/* 01 .. FF, full block is not followed by a zero. */
+	for (size_t i = 0; i < 255; i++) {
+		data[i] = i + 1;
+	}
+	enc[0] = 0xFF;
+	for (size_t i = 0; i < 254; i++) {
+		enc[i + 1] = i + 1;
+	}
+	enc[255] = 0x02;
+	enc[256] = 0xFF;
+	v.len = 255;
+	v.enc_len = 257;
+	prv_check_vector(&v);
+
+	/* 02 .. FF 00, zero after a full block. */
+	for (size_t i = 0; i < 254; i++) {
+		data[i] = i + 2;
+		enc[i + 1] = i + 2;
+	}
+	data[254] = 0x00;
+	enc[0] = 0xFF;
+	enc[255] = 0x01;
+	enc[256] = 0x01;
+	v.len = 255;
+	v.enc_len = 257;
+	prv_check_vector(&v);
+
+	/* 03 .. FF 00 01, block that is one byte short of full. */
+	for (size_t i = 0; i < 253; i++) {
+		data[i] = i + 3;
+		enc[i + 1] = i + 3;
+	}
+	data[253] = 0x00;
+	data[254] = 0x01;
+	enc[0] = 0xFE;
+	enc[254] = 0x02;
+	enc[255] = 0x01;
+	v.len = 255;
+	v.enc_len = 256;
+	prv_check_vector(&v);
+}
+
+ZTEST(notecard_cobs, test_round_trip)
+{
+	/* Probability of a zero byte, in 1/256. */
+	static const uint16_t zero_densities[] = {0, 1, 16, 128, 256};
+	uint32_t seed = 1;
+
+	/* Data is deterministic pseudo random, so failures can be reproduced. */
+	for (size_t d = 0; d < ARRAY_SIZE(zero_densities); d++) {
+		for (size_t len = 0; len <= DATA_MAX_LEN; len += 7) {
+			for (size_t i = 0; i < len; i++) {
+				seed = seed * 1103515245 + 12345;
+
+				bool is_zero = ((seed >> 24) & 0xFF) < zero_densities[d];
+
+				prv_data[i] = is_zero ? 0 : (seed >> 16) | 1;
+			}
+
+			prv_round_trip(prv_data, len);
+		}
+	}
+}
+
+ZTEST(notecard_cobs, test_decode_buffer_too_small)
+{
+	static const uint8_t data[] = {0x11, 0x22, 0x00, 0x33};
+	static const uint8_t trailing_zero[] = {0x11, 0x00};
+
+	size_t enc_len = prv_encode(data, sizeof(data), sizeof(prv_enc));
+
+	zassert_equal(prv_decode(prv_enc, enc_len - 1, sizeof(data)), (int)sizeof(data));
+	zassert_equal(prv_decode(prv_enc, enc_len - 1, sizeof(data) - 1), -EMSGSIZE);
+
+	/* Zero at the end of the data is output only when the block after it starts. */
+	enc_len = prv_encode(trailing_zero, sizeof(trailing_zero), sizeof(prv_enc));
+
+	zassert_equal(prv_decode(prv_enc, enc_len - 1, sizeof(trailing_zero)),
+		      (int)sizeof(trailing_zero));
+	zassert_equal(prv_decode(prv_enc, enc_len - 1, sizeof(trailing_zero) - 1), -EMSGSIZE);
+}
+
+ZTEST(notecard_cobs, test_decode_malformed)
+{
+	static const uint8_t data[] = {0x11, 0x22, 0x00, 0x33};
+
+	size_t enc_len = prv_encode(data, sizeof(data), sizeof(prv_enc));
+
+	/* Data ends in the middle of a block. */
+	for (size_t i = 1; i < enc_len - 1; i++) {
+		if (i == 3) {
+			/* Data that ends between the blocks looks like shorter data. */
+			zassert_equal(prv_decode(prv_enc, i, sizeof(prv_dec)), 2);
+			continue;
+		}
+		zassert_equal(prv_decode(prv_enc, i, sizeof(prv_dec)), -EBADMSG,
+			      "Data truncated to %zu bytes was accepted", i);
+	}
+
+	/* Zero code byte. */
+	prv_enc[3] = 0x00 ^ COBS_EOP;
+	zassert_equal(prv_decode(prv_enc, enc_len - 1, sizeof(prv_dec)), -EBADMSG);
+}
+
+ZTEST_SUITE(notecard_cobs, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,338 @@
+/** @file main.c
+ *
+ * @brief Streaming JSON parser tests.
+ *
+ * Every document is fed to the parser in chunks of every possible size, from single bytes to the
+ * whole document at once, so each token is also split at every position between two chunks.
+ * Tests assert the reported fields, their nesting, unescaping of strings (including surrogate
+ * pairs) and that malformed documents are rejected.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include "notecard_private.h"
+
+#include <notecard.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#define KEY_MAX_LEN   CONFIG_NOTECARD_JSON_KEY_MAX_LEN
+#define VALUE_MAX_LEN CONFIG_NOTECARD_JSON_VALUE_MAX_LEN
+/* Nesting limit of the parser. */
+#define MAX_DEPTH     31
+#define MAX_FIELDS    (2 * MAX_DEPTH + 2)
+
+/* Field as reported by the parser, copied out of the callback. */
+struct field_rec {
+	bool has_key;
+	char key[KEY_MAX_LEN + 1];
+	uint8_t depth;
+	enum notecard_json_type type;
+	char value[VALUE_MAX_LEN + 1];
+	size_t value_len;
+	bool more;
+};
+
+/* Expected field, key is NULL if the field has none. */
+struct field_exp {
+	const char *key;
+	uint8_t depth;
+	enum notecard_json_type type;
+	const char *value;
+	bool more;
+};
+
+static struct field_rec prv_fields[MAX_FIELDS];
+static size_t prv_field_count;
+
+/* Callback returns prv_stop_rc for the field with this index, 0 to never stop. */
+static size_t prv_stop_at;
+static int prv_stop_rc;
+
+static int prv_field_cb(const struct notecard_json_field *field, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (prv_field_count == ARRAY_SIZE(prv_fields)) {
+		return -ENOSPC;
+	}
+
+	struct field_rec *rec = &prv_fields[prv_field_count++];
+
+	zassert_true(field->value_len <= VALUE_MAX_LEN, "Value is too long");
+	zassert_equal(field->value[field->value_len], '\0', "Value is not terminated");
+
+	rec->has_key = field->key != NULL;
+	if (rec->has_key) {
+		zassert_true(strlen(field->key) <= KEY_MAX_LEN, "Key is too long");
+		strcpy(rec->key, field->key);
+	}
+	rec->depth = field->depth;
+	rec->type = field->type;
+	memcpy(rec->value, field->value, field->value_len);
+	rec->value_len = field->value_len;
+	rec->more = field->more;
+
+	return prv_field_count == prv_stop_at ? prv_stop_rc : 0;
+}
+
+/**
+ * @brief Parse the document, fed to the parser in chunks of the given length.
+ *
+ * @return Same as notecard_json_parser_finish().
+ */
+static int prv_parse(const char *json, size_t chunk_len)
+{
+	struct notecard_json_parser p;
+	size_t len = strlen(json);
+
+	prv_field_count = 0;
+	notecard_json_parser_init(&p, prv_field_cb, NULL);
+
+	for (size_t pos = 0; pos < len; pos += chunk_len) {
+		notecard_json_parser_feed(&p, &json[pos], MIN(chunk_len, len - pos));
+	}
+
+	return notecard_json_parser_finish(&p);
+}
+
+/**
+ * @brief Parse the document in chunks of every size and check the reported fields.
+ */
+static void prv_check(const char *json, const struct field_exp *exp, size_t count)
+{
+	for (size_t chunk_len = 1; chunk_len <= strlen(json); chunk_len++) {
+		zassert_ok(prv_parse(json, chunk_len), "Parsing failed in chunks of %zu",
+			   chunk_len);
+		zassert_equal(prv_field_count, count,
+			      "Got %zu fields instead of %zu in chunks of %zu", prv_field_count,
+			      count, chunk_len);
+
+		for (size_t i = 0; i < count; i++) {
+			const struct field_rec *rec = &prv_fields[i];
+			const char *value = exp[i].value ? exp[i].value : "";
+
+			zassert_equal(rec->has_key, exp[i].key != NULL, "Field %zu key presence",
+				      i);
+			if (exp[i].key) {
+				zassert_str_equal(rec->key, exp[i].key, "Field %zu key", i);
+			}
+			zassert_equal(rec->depth, exp[i].depth, "Field %zu depth", i);
+			zassert_equal(rec->type, exp[i].type, "Field %zu type", i);
+			zassert_equal(rec->value_len, strlen(value), "Field %zu value length", i);
+			zassert_mem_equal(rec->value, value, rec->value_len, "Field %zu value", i);
+			zassert_equal(rec->more, exp[i].more, "Field %zu more flag", i);
+		}
+	}
+}
+
+/**
+ * @brief Check that the document is rejected, wherever it is split.
+ */
+static void prv_check_malformed(const char *json)
+{
+	for (size_t chunk_len = 1; chunk_len <= MAX(strlen(json), 1); chunk_len++) {
+		zassert_equal(prv_parse(json, chunk_len), -EBADMSG,
+			      "\"%s\" was accepted in chunks of %zu", json, chunk_len);
+	}
+}
+
+ZTEST(notecard_json, test_nested)
+{
+	static const char json[] =
+		"{\"a\":1,\"b\":[true,null,{\"c\":\"x\"}],\"d\":{},\"e\":[[-1.5e+3,false]]}";
+	static const struct field_exp exp[] = {
+		{NULL, 0, NOTECARD_JSON_OBJECT_BEGIN},
+		{"a", 1, NOTECARD_JSON_NUMBER, "1"},
+		{"b", 1, NOTECARD_JSON_ARRAY_BEGIN},
+		{NULL, 2, NOTECARD_JSON_BOOL, "true"},
+		{NULL, 2, NOTECARD_JSON_NULL, "null"},
+		{NULL, 2, NOTECARD_JSON_OBJECT_BEGIN},
+		{"c", 3, NOTECARD_JSON_STRING, "x"},
+		{NULL, 2, NOTECARD_JSON_OBJECT_END},
+		{NULL, 1, NOTECARD_JSON_ARRAY_END},
+		{"d", 1, NOTECARD_JSON_OBJECT_BEGIN},
+		{NULL, 1, NOTECARD_JSON_OBJECT_END},
+		{"e", 1, NOTECARD_JSON_ARRAY_BEGIN},
+		{NULL, 2, NOTECARD_JSON_ARRAY_BEGIN},
+		{NULL, 3, NOTECARD_JSON_NUMBER, "-1.5e+3"},
+		{NULL, 3, NOTECARD_JSON_BOOL, "false"},
+		{NULL, 2, NOTECARD_JSON_ARRAY_END},
+		{NULL, 1, NOTECARD_JSON_ARRAY_END},
+		{NULL, 0, NOTECARD_JSON_OBJECT_END},
+	};
+
+	prv_check(json, exp, ARRAY_SIZE(exp));
+}
+
+ZTEST(notecard_json, test_whitespace_and_trailing_data)
+{
+	/* Anything after the top level value is ignored. */
+	static const char json[] = " \t{ \"a\" :\r\n 12 , \"b\" : [ ] } trailing";
+	static const struct field_exp exp[] = {
+		{NULL, 0, NOTECARD_JSON_OBJECT_BEGIN},
+		{"a", 1, NOTECARD_JSON_NUMBER, "12"},
+		{"b", 1, NOTECARD_JSON_ARRAY_BEGIN},
+		{NULL, 1, NOTECARD_JSON_ARRAY_END},
+		{NULL, 0, NOTECARD_JSON_OBJECT_END},
+	};
+
+	prv_check(json, exp, ARRAY_SIZE(exp));
+}
+
+ZTEST(notecard_json, test_top_level_literal)
+{
+	/* Number at the end of the document is only complete when parsing is finished. */
+	static const struct field_exp exp[] = {
+		{NULL, 0, NOTECARD_JSON_NUMBER, "42"},
+	};
+
+	prv_check("42", exp, ARRAY_SIZE(exp));
+}
+
+ZTEST(notecard_json, test_escapes)
+{
+	static const char json[] =
+		"{\"k\\\"ey\":\"a\\\"b\\\\c\\/d\\b\\f\\n\\r\\t\\u00e9\\u20AC\\u0041\"}";
+	static const struct field_exp exp[] = {
+		{NULL, 0, NOTECARD_JSON_OBJECT_BEGIN},
+		{"k\"ey", 1, NOTECARD_JSON_STRING, "a\"b\\c/d\b\f\n\r\t\xc3\xa9\xe2\x82\xac" "A"},
+		{NULL, 0, NOTECARD_JSON_OBJECT_END},
+	};
+
+	prv_check(json, exp, ARRAY_SIZE(exp));
+}
+
+ZTEST(notecard_json, test_surrogate_pairs)
+{
+	/* Surrogates that are not part of a pair are replaced with U+FFFD. */
+	static const char json[] = "[\"\\ud83d\\ude00\",\"\\uD83D\\uDE00x\",\"\\ud83d\","
+				   "\"\\ude00x\",\"\\ud83d\\u0041\",\"\\ud83dA\","
+				   "\"\\ud83d\\ud83d\\ude00\"]";
+	static const struct field_exp exp[] = {
+		{NULL, 0, NOTECARD_JSON_ARRAY_BEGIN},
+		{NULL, 1, NOTECARD_JSON_STRING, "\xf0\x9f\x98\x80"},
+		{NULL, 1, NOTECARD_JSON_STRING, "\xf0\x9f\x98\x80x"},
+		{NULL, 1, NOTECARD_JSON_STRING, "\xef\xbf\xbd"},
+		{NULL, 1, NOTECARD_JSON_STRING, "\xef\xbf\xbdx"},
+		{NULL, 1, NOTECARD_JSON_STRING, "\xef\xbf\xbd" "A"},
+		{NULL, 1, NOTECARD_JSON_STRING, "\xef\xbf\xbd" "A"},
+		{NULL, 1, NOTECARD_JSON_STRING, "\xef\xbf\xbd\xf0\x9f\x98\x80"},
+		{NULL, 0, NOTECARD_JSON_ARRAY_END},
+	};
+
+	prv_check(json, exp, ARRAY_SIZE(exp));
+}
+
+ZTEST(notecard_json, test_long_key_and_value)
+{
+	/* Key is truncated, value is reported in pieces of VALUE_MAX_LEN characters. */
+	static char key[KEY_MAX_LEN + 9];
+	static char value[2 * VALUE_MAX_LEN + 7];
+	static char pieces[3][VALUE_MAX_LEN + 1];
+	static char json[sizeof(key) + sizeof(value) + 16];
+
+	for (size_t i = 0; i < sizeof(key) - 1; i++) {
+		key[i] = 'a' + i % 26;
+	}
+	for (size_t i = 0; i < sizeof(value) - 1; i++) {
+		value[i] = 'A' + i % 26;
+	}
+	for (size_t i = 0; i < ARRAY_SIZE(pieces); i++) {
+		strncpy(pieces[i], &value[i * VALUE_MAX_LEN], VALUE_MAX_LEN);
+	}
+	snprintf(json, sizeof(json), "{\"%s\":\"%s\"}", key, value);
+	key[KEY_MAX_LEN] = '\0';
+
+	const struct field_exp exp[] = {
+		{NULL, 0, NOTECARD_JSON_OBJECT_BEGIN},
+		{key, 1, NOTECARD_JSON_STRING, pieces[0], true},
+		{key, 1, NOTECARD_JSON_STRING, pieces[1], true},
+		{key, 1, NOTECARD_JSON_STRING, pieces[2], false},
+		{NULL, 0, NOTECARD_JSON_OBJECT_END},
+	};
+
+	prv_check(json, exp, ARRAY_SIZE(exp));
+}
+
+ZTEST(notecard_json, test_max_depth)
+{
+	static char json[2 * (MAX_DEPTH + 1) + 1];
+
+	memset(json, '[', MAX_DEPTH);
+	memset(&json[MAX_DEPTH], ']', MAX_DEPTH);
+	json[2 * MAX_DEPTH] = '\0';
+
+	zassert_ok(prv_parse(json, sizeof(json)));
+	zassert_equal(prv_field_count, 2 * MAX_DEPTH);
+	zassert_equal(prv_fields[MAX_DEPTH - 1].depth, MAX_DEPTH - 1);
+
+	memset(json, '[', MAX_DEPTH + 1);
+	memset(&json[MAX_DEPTH + 1], ']', MAX_DEPTH + 1);
+	json[2 * (MAX_DEPTH + 1)] = '\0';
+
+	prv_check_malformed(json);
+}
+
+ZTEST(notecard_json, test_malformed)
+{
+	static char long_number[VALUE_MAX_LEN + 8];
+	static const char *const docs[] = {
+		"",
+		"   ",
+		"}",
+		"{\"a\" 1}",
+		"{\"a\":}",
+		"{\"a\":1,}",
+		"{\"a\":1 \"b\":2}",
+		"{a:1}",
+		"{1:2}",
+		"[1,2}",
+		"{\"a\":[1]]",
+		"{\"a\":tru}",
+		"{\"a\":\"\\x\"}",
+		"{\"a\":\"\\u12g4\"}",
+		"{\"a\":1",
+		"{\"a\":\"abc",
+		"{\"a\":\"\\u12",
+		"[1,",
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(docs); i++) {
+		prv_check_malformed(docs[i]);
+	}
+
+	/* Numbers are never split in pieces, too long is malformed. */
+	memset(long_number, '1', sizeof(long_number) - 1);
+	prv_check_malformed(long_number);
+}
+
+ZTEST(notecard_json, test_callback_stop)
+{
+	/* Value returned by the callback is returned by the parser and no more fields are
+	 * reported, but the rest of the document is still checked. */
+	prv_stop_at = 3;
+	prv_stop_rc = 5;
+
+	zassert_equal(prv_parse("{\"a\":1,\"b\":2,\"c\":3}", 1), 5);
+	zassert_equal(prv_field_count, 3);
+	zassert_str_equal(prv_fields[2].key, "b");
+
+	zassert_equal(prv_parse("{\"a\":1,\"b\":2,\"c\":", 1), -EBADMSG);
+	zassert_equal(prv_field_count, 3);
+}
+
+static void prv_after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	prv_stop_at = 0;
+	prv_stop_rc = 0;
+}
+
+ZTEST_SUITE(notecard_json, NULL, NULL, NULL, prv_after, NULL);
@@ -0,0 +1,263 @@
+/** @file main.c
+ *
+ * @brief Contention stress test.
+ *
+ * Several producer threads at mixed priorities share a single emulated Notecard. Each producer
+ * takes the control, sends a request and releases the control in a loop. Most requests are small
+ * queries, some are note.update requests with a large payload that put pressure on the
+ * deliberately small heap. After the run, tests assert the starvation and heap exhaustion bounds
+ * and that the control was never held by two threads at once.
+ *
+ * @par
+ * COPYRIGHT NOTICE: (c) 2026 Irnas. All rights reserved.
+ */
+
+#include <notecard.h>
+
+#include <note.h>
+
+#include <string.h>
+
+#include <zephyr/device.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/ztest.h>
+
+#define NUM_THREADS	   5
+#define THREAD_STACK_SIZE  3072
+#define DURATION_MS	   10000
+/* Waiting for the control longer than this counts as a starvation event. */
+#define STARVATION_MS	   1000
+#define LARGE_PAYLOAD_SIZE 2048
+/* Highest share of requests of a thread that may wait for the control longer than
+ * STARVATION_MS, in percent. */
+#define STARVED_MAX_PERCENT 5
+/* Requests are built and sent while the control is held, so a single request has the whole heap
+ * and no allocation may fail. */
+#define ALLOC_FAILURES_MAX 0
+
+const struct device *prv_notecard_dev = DEVICE_DT_GET(DT_NODELABEL(notecard));
+
+/* Producers at mixed priorities, like application threads that share a single Notecard. */
+static const int prv_priorities[NUM_THREADS] = {1, 3, 5, 5, 7};
+
+K_THREAD_STACK_ARRAY_DEFINE(prv_stacks, NUM_THREADS, THREAD_STACK_SIZE);
+static struct k_thread prv_threads[NUM_THREADS];
+
+struct producer_stats {
+	uint32_t iterations;
+	uint32_t failed;
+	uint32_t timeouts;
+	uint32_t starved;
+	uint32_t max_wait_us;
+	uint64_t total_wait_us;
+};
+
+static struct producer_stats prv_stats[NUM_THREADS];
+
+static char prv_payload[LARGE_PAYLOAD_SIZE + 1];
+
+static atomic_t prv_stop;
+
+/* Number of threads between the post take and the pre release callback, needs to be at most 1. */
+static atomic_t prv_inside;
+static atomic_t prv_violations;
+
+static void prv_post_take_cb(const struct device *dev, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (atomic_inc(&prv_inside) != 0 || notecard_ctrl_owner() != dev) {
+		atomic_inc(&prv_violations);
+	}
+}
+
+static void prv_pre_release_cb(const struct device *dev, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	if (atomic_dec(&prv_inside) != 1 || notecard_ctrl_owner() != dev) {
+		atomic_inc(&prv_violations);
+	}
+}
+
+/**
+ * @brief Simple per-thread pseudo random generator, so runs are reproducible.
+ */
+static uint32_t prv_rand(uint32_t *state)
+{
+	*state = *state * 1103515245U + 12345U;
+
+	return *state >> 16;
+}
+
+/**
+ * @brief Build request: mostly small queries, sometimes a large note.update that puts pressure on
+ * the heap.
+ */
+static J *prv_request(uint32_t *rand_state)
+{
+	uint32_t r = prv_rand(rand_state) % 10;
+
+	if (r < 6) {
+		return NoteNewRequest(r < 3 ? "card.status" : "hub.status");
+	}
+
+	size_t payload_size = r < 9 ? 64 : LARGE_PAYLOAD_SIZE;
+
+	J *req = NoteNewRequest("note.update");
+	if (!req) {
+		return NULL;
+	}
+
+	JAddStringToObject(req, "file", "stress.dbx");
+	JAddStringToObject(req, "note", "stress");
+	J *body = JAddObjectToObject(req, "body");
+	JAddStringToObject(body, "payload", &prv_payload[LARGE_PAYLOAD_SIZE - payload_size]);
+
+	return req;
+}
+
+static void prv_producer(void *p1, void *p2, void *p3)
+{
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	size_t idx = (size_t)p1;
+	struct producer_stats *stats = &prv_stats[idx];
+	uint32_t rand_state = idx + 1;
+
+	while (!atomic_get(&prv_stop)) {
+		uint32_t start = k_cycle_get_32();
+
+		/* Highest priority thread sends alarms, it gives up instead of waiting forever. */
+		if (idx == 0) {
+			if (notecard_ctrl_take_timeout(prv_notecard_dev, K_MSEC(STARVATION_MS))) {
+				stats->timeouts++;
+				continue;
+			}
+		} else {
+			notecard_ctrl_take(prv_notecard_dev);
+		}
+
+		uint32_t wait_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		J *rsp = NoteRequestResponse(prv_request(&rand_state));
+
+		if (!rsp || NoteResponseError(rsp)) {
+			stats->failed++;
+		}
+
+		NoteDeleteResponse(rsp);
+		notecard_ctrl_release(prv_notecard_dev);
+
+		stats->iterations++;
+		stats->total_wait_us += wait_us;
+		stats->max_wait_us = MAX(stats->max_wait_us, wait_us);
+		if (wait_us >= STARVATION_MS * USEC_PER_MSEC) {
+			stats->starved++;
+		}
+
+		/* Give lower priority threads a chance, like a producer waiting for new data. */
+		k_msleep(prv_rand(&rand_state) % 20);
+	}
+}
+
+static void prv_hist_print(const char *name, const struct notecard_latency_hist *hist)
+{
+	TC_PRINT("%s: count %u, p50 %u us, p90 %u us, p99 %u us, max %u us\n", name, hist->count,
+		 notecard_latency_hist_percentile(hist, 50),
+		 notecard_latency_hist_percentile(hist, 90),
+		 notecard_latency_hist_percentile(hist, 99), hist->max_us);
+}
+
+static void *prv_setup(void)
+{
+	memset(prv_payload, 'x', LARGE_PAYLOAD_SIZE);
+
+	notecard_ctrl_take(prv_notecard_dev);
+	bool present = notecard_is_present(prv_notecard_dev);
+	notecard_ctrl_release(prv_notecard_dev);
+
+	zassert_true(present, "Emulated notecard not present");
+
+	notecard_post_take_cb_register(prv_notecard_dev, prv_post_take_cb, NULL);
+	notecard_pre_release_cb_register(prv_notecard_dev, prv_pre_release_cb, NULL);
+	notecard_stats_reset(prv_notecard_dev);
+
+	for (size_t i = 0; i < NUM_THREADS; i++) {
+		k_thread_create(&prv_threads[i], prv_stacks[i], K_THREAD_STACK_SIZEOF(prv_stacks[i]),
+				prv_producer, (void *)i, NULL, NULL, prv_priorities[i], 0, K_NO_WAIT);
+	}
+
+	k_msleep(DURATION_MS);
+	atomic_set(&prv_stop, 1);
+
+	for (size_t i = 0; i < NUM_THREADS; i++) {
+		k_thread_join(&prv_threads[i], K_FOREVER);
+	}
+
+	for (size_t i = 0; i < NUM_THREADS; i++) {
+		struct producer_stats *s = &prv_stats[i];
+
+		TC_PRINT("Thread %zu (prio %d): %u requests, %u failed, %u timeouts, wait avg %u us, "
+			 "max %u us, %u starved\n",
+			 i, prv_priorities[i], s->iterations, s->failed, s->timeouts,
+			 s->iterations ? (uint32_t)(s->total_wait_us / s->iterations) : 0,
+			 s->max_wait_us, s->starved);
+	}
+
+	struct notecard_stats stats;
+
+	notecard_stats_get(prv_notecard_dev, &stats);
+	prv_hist_print("Lock wait", &stats.lock_wait);
+	prv_hist_print("Lock hold", &stats.lock_hold);
+
+	return NULL;
+}
+
+ZTEST(notecard_stress, test_mutual_exclusion)
+{
+	zassert_equal(atomic_get(&prv_violations), 0,
+		      "Control was held by more than one thread at once");
+}
+
+ZTEST(notecard_stress, test_starvation)
+{
+	/* Highest priority thread is first in line for the control, so it only waits for the
+	 * current owner and never runs into its timeout. */
+	zassert_equal(prv_stats[0].timeouts, 0, "Highest priority thread timed out");
+
+	for (size_t i = 0; i < NUM_THREADS; i++) {
+		struct producer_stats *s = &prv_stats[i];
+
+		zassert_true(s->iterations > 0, "Thread %zu never got the control", i);
+		zassert_true(s->starved * 100 <= s->iterations * STARVED_MAX_PERCENT,
+			     "Thread %zu starved %u times in %u requests", i, s->starved,
+			     s->iterations);
+	}
+}
+
+ZTEST(notecard_stress, test_heap_exhaustion)
+{
+	struct notecard_mem_stats mem_stats;
+
+	notecard_ctrl_take(prv_notecard_dev);
+	int rc = notecard_mem_stats_get(prv_notecard_dev, &mem_stats);
+	notecard_ctrl_release(prv_notecard_dev);
+
+	zassert_ok(rc);
+
+	TC_PRINT("Heap: peak %zu B, %u failed allocations\n", mem_stats.max_allocated_bytes,
+		 mem_stats.alloc_failures);
+
+	zassert_true(mem_stats.alloc_failures <= ALLOC_FAILURES_MAX, "%u allocations failed",
+		     mem_stats.alloc_failures);
+
+	for (size_t i = 0; i < NUM_THREADS; i++) {
+		zassert_equal(prv_stats[i].failed, 0, "Thread %zu had %u failed requests", i,
+			      prv_stats[i].failed);
+	}
+}
+
+ZTEST_SUITE(notecard_stress, NULL, prv_setup, NULL, NULL, NULL);